@@ -9,7 +9,26 @@
  *
  * Usage:
  *   sudo ./poc_bench [-i ITERS] [-t THREADS] [-b BACKGROUND]
- *                    [-w WARMUP] [--no-compare]
+ *                    [-w WARMUP] [-k KNOB] [-s SCENARIOS] [-g GROUPS]
+ *                    [--no-compare] [--precise] [--gap NS]
+ *                    [--sweep [--sweep-steps N]
+ *                    [--sweep-threads LIST] [--sweep-knobs LIST|all]]
+ *
+ * Scenarios (-s, comma-separated or "all"; default "burst"):
+ *   burst   dispatcher writing to per-worker eventfds
+ *   pipe    request/response pairs over pipes (WF_SYNC wakeups)
+ *   futex   thread pool woken by one FUTEX_WAKE per round
+ *   fanout  hackbench-style senders writing to many sockets
+ *
+ * The ON/OFF comparison toggles kernel.sched_poc_selector by default;
+ * --knob selects another boolean POC sysctl instead, e.g.
+ * "--knob sched_poc_sharded" to A/B the flat and sharded mask layouts.
+ *
+ * --sweep replaces the comparison with a curve: the background load
+ * steps from 0 to nproc-1 CPUs (optionally for several worker counts)
+ * and every point is measured with the knob off and with it on under
+ * each combination of the --sweep-knobs sysctls, reporting p50, p99,
+ * p99.9 and ops/s per point.
  *
  * Copyright (C) 2026 — for use with BORE scheduler + POC Selector
  */
@@ -23,9 +42,15 @@
 #include <sched.h>
 #include <pthread.h>
 #include <signal.h>
+#include <limits.h>
 #include <sys/eventfd.h>
+#include <sys/ioctl.h>
 #include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
 #include <sys/sysinfo.h>
+#include <linux/futex.h>
+#include <linux/perf_event.h>
 #include <getopt.h>
 #include <math.h>
 #include <stdatomic.h>
@@ -122,6 +147,52 @@ static int count_physical_cores(void)
 	return count > 0 ? count : get_nprocs();
 }
 
+/*
+ * Per-CPU core and cluster IDs (first CPU of thread_siblings_list and
+ * cluster_cpus_list; a CPU is its own core and cluster when sysfs does
+ * not say).  Used to classify where a woken worker landed.
+ */
+struct cpu_topo {
+	int core;
+	int cluster;
+};
+
+static struct cpu_topo *cpu_topo;
+static int nr_cpu_ids;
+
+static int read_first_cpu(int cpu, const char *file)
+{
+	char path[256], buf[64];
+	int first = -1;
+
+	snprintf(path, sizeof(path),
+		 "/sys/devices/system/cpu/cpu%d/topology/%s", cpu, file);
+	FILE *f = fopen(path, "r");
+	if (!f)
+		return -1;
+	if (fgets(buf, sizeof(buf), f))
+		sscanf(buf, "%d", &first);
+	fclose(f);
+	return first;
+}
+
+static void read_cpu_topology(void)
+{
+	nr_cpu_ids = get_nprocs_conf();
+	cpu_topo = calloc(nr_cpu_ids, sizeof(*cpu_topo));
+	if (!cpu_topo) {
+		perror("calloc");
+		exit(1);
+	}
+	for (int i = 0; i < nr_cpu_ids; i++) {
+		int core = read_first_cpu(i, "thread_siblings_list");
+		int cluster = read_first_cpu(i, "cluster_cpus_list");
+
+		cpu_topo[i].core = core >= 0 ? core : i;
+		cpu_topo[i].cluster = cluster >= 0 ? cluster : cpu_topo[i].core;
+	}
+}
+
 /* ------------------------------------------------------------------ */
 /*  Constants                                                          */
 /* ------------------------------------------------------------------ */
@@ -129,7 +200,12 @@ static int count_physical_cores(void)
 #define DEFAULT_ITERATIONS  100000
 #define DEFAULT_WARMUP      5000
 #define COMPARE_ROUNDS      3
-#define SYSCTL_PATH         "/proc/sys/kernel/sched_poc_selector"
+#define SYSCTL_DIR          "/proc/sys/kernel/"
+#define DEFAULT_KNOB        "sched_poc_selector"
+#define DEFAULT_GROUPS      2
+#define DEFAULT_GAP_NS      1000	/* nanosleep() between burst rounds */
+#define PRECISE_GAP_NS      10000	/* busy-wait between rounds, --precise */
+#define CACHELINE           64
 #define NS_PER_US           1000ULL
 #define NS_PER_SEC          1000000000ULL
 
@@ -144,6 +220,119 @@ static inline uint64_t now_ns(void)
 	return (uint64_t)ts.tv_sec * NS_PER_SEC + (uint64_t)ts.tv_nsec;
 }
 
+/* ------------------------------------------------------------------ */
+/*  Utility: busy-wait pacing and locked buffers (--precise)           */
+/* ------------------------------------------------------------------ */
+
+/*
+ * nanosleep() between rounds really sleeps for the timer slack (~50 us)
+ * and puts the dispatcher's own CPU through an idle transition.  The
+ * precise mode spins on the TSC instead; elsewhere on the clock.
+ */
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+static inline uint64_t pace_ticks(void) { return __rdtsc(); }
+static inline void cpu_relax(void) { __builtin_ia32_pause(); }
+#else
+static inline uint64_t pace_ticks(void) { return now_ns(); }
+#if defined(__aarch64__)
+static inline void cpu_relax(void) { __asm__ __volatile__("yield"); }
+#else
+static inline void cpu_relax(void) { }
+#endif
+#endif
+
+static double pace_ticks_per_ns = 1.0;
+
+/* Ticks per nanosecond, over 20 ms */
+static void pace_calibrate(void)
+{
+	uint64_t t0 = now_ns(), c0 = pace_ticks();
+	while (now_ns() - t0 < 20000 * NS_PER_US)
+		cpu_relax();
+	uint64_t t1 = now_ns(), c1 = pace_ticks();
+	pace_ticks_per_ns = (double)(c1 - c0) / (double)(t1 - t0);
+}
+
+static inline void pace_wait_ns(uint64_t ns)
+{
+	uint64_t end = pace_ticks() + (uint64_t)(ns * pace_ticks_per_ns);
+	while (pace_ticks() < end)
+		cpu_relax();
+}
+
+/*
+ * One mapping per run for every buffer the measured threads touch,
+ * faulted in and locked before the first wakeup so no page fault lands
+ * inside the measured window.  Allocations are cache-line aligned.
+ */
+struct arena {
+	char  *base;
+	size_t size;
+	size_t used;
+};
+
+static void arena_init(struct arena *a, size_t size)
+{
+	a->size = (size + 4095) & ~(size_t)4095;
+	a->used = 0;
+	a->base = mmap(NULL, a->size, PROT_READ | PROT_WRITE,
+		       MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+	if (a->base == MAP_FAILED) {
+		perror("mmap");
+		exit(1);
+	}
+	if (mlock(a->base, a->size) < 0)
+		perror("mlock");	/* populated anyway, just not pinned */
+	memset(a->base, 0, a->size);
+}
+
+static void *arena_alloc(struct arena *a, size_t size)
+{
+	size_t off = (a->used + CACHELINE - 1) & ~(size_t)(CACHELINE - 1);
+	if (off + size > a->size) {
+		fprintf(stderr, "arena overflow\n");
+		exit(1);
+	}
+	a->used = off + size;
+	return a->base + off;
+}
+
+static void arena_free(struct arena *a)
+{
+	munmap(a->base, a->size);
+}
+
+/* Pin the calling thread to @cpu at SCHED_FIFO 1, like the Rust dispatcher */
+struct saved_sched {
+	cpu_set_t          affinity;
+	int                policy;
+	struct sched_param param;
+	bool               fifo;
+};
+
+static void dispatcher_enter(struct saved_sched *sv, int cpu)
+{
+	struct sched_param fifo = { .sched_priority = 1 };
+	cpu_set_t set;
+
+	sched_getaffinity(0, sizeof(sv->affinity), &sv->affinity);
+	sv->policy = sched_getscheduler(0);
+	sched_getparam(0, &sv->param);
+
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	sched_setaffinity(0, sizeof(set), &set);
+	sv->fifo = sched_setscheduler(0, SCHED_FIFO, &fifo) == 0;
+}
+
+static void dispatcher_leave(const struct saved_sched *sv)
+{
+	if (sv->fifo)
+		sched_setscheduler(0, sv->policy, &sv->param);
+	sched_setaffinity(0, sizeof(sv->affinity), &sv->affinity);
+}
+
 /* ------------------------------------------------------------------ */
 /*  Utility: statistics                                                */
 /* ------------------------------------------------------------------ */
@@ -160,6 +349,42 @@ static int cmp_u64(const void *a, const void *b)
 	return (va > vb) - (va < vb);
 }
 
+/*
+ * Where the woken workers landed, relative to the CPU each one woke on
+ * last time.  The first five are exclusive and checked in order;
+ * collided counts wakeups that shared a CPU with another worker's
+ * wakeup of the same round.
+ */
+struct placement {
+	uint64_t total;
+	uint64_t same_cpu;	/* previous CPU again */
+	uint64_t busy_cpu;	/* a background-loaded CPU */
+	uint64_t smt_busy;	/* SMT sibling of a background-loaded CPU */
+	uint64_t same_cluster;	/* previous CPU's cluster */
+	uint64_t other_cluster;
+	uint64_t collided;
+};
+
+/*
+ * Counters of the threads that wake or are woken, summed over their
+ * wake and wait syscalls in one run; wakeups includes warmup, like the
+ * counting window does.
+ */
+enum perf_counter {
+	PERF_CYCLES,
+	PERF_KCYCLES,		/* in the kernel: wakeup path, selector, switch */
+	PERF_CSW,
+	PERF_MIGRATIONS,
+	PERF_LLC_MISSES,
+	NR_PERF
+};
+
+struct perf_counts {
+	uint64_t wakeups;
+	uint64_t val[NR_PERF];
+	bool     valid[NR_PERF];
+};
+
 struct stat_result {
 	double   mean;
 	double   stddev;
@@ -167,6 +392,9 @@ struct stat_result {
 	uint64_t max;
 	uint64_t p50;
 	uint64_t p99;
+	uint64_t p999;
+	struct placement place;
+	struct perf_counts perf;
 };
 
 static struct stat_result stats_compute(struct stats *s)
@@ -181,6 +409,7 @@ static struct stat_result stats_compute(struct stats *s)
 	r.max = s->samples[s->n - 1];
 	r.p50 = s->samples[s->n / 2];
 	r.p99 = s->samples[(int)((s->n - 1) * 0.99)];
+	r.p999 = s->samples[(int)((s->n - 1) * 0.999)];
 
 	double sum = 0;
 	for (int i = 0; i < s->n; i++)
@@ -197,6 +426,27 @@ static struct stat_result stats_compute(struct stats *s)
 	return r;
 }
 
+static void placement_add(struct placement *dst, const struct placement *src)
+{
+	dst->total         += src->total;
+	dst->same_cpu      += src->same_cpu;
+	dst->busy_cpu      += src->busy_cpu;
+	dst->smt_busy      += src->smt_busy;
+	dst->same_cluster  += src->same_cluster;
+	dst->other_cluster += src->other_cluster;
+	dst->collided      += src->collided;
+}
+
+static void perf_add(struct perf_counts *dst, const struct perf_counts *src,
+		     bool first)
+{
+	dst->wakeups += src->wakeups;
+	for (int i = 0; i < NR_PERF; i++) {
+		dst->val[i] += src->val[i];
+		dst->valid[i] = (first || dst->valid[i]) && src->valid[i];
+	}
+}
+
 static struct stat_result stats_merge(struct stat_result *results, int n)
 {
 	struct stat_result m = {0};
@@ -205,7 +455,7 @@ static struct stat_result stats_merge(struct stat_result *results, int n)
 
 	double sum_mean = 0, sum_stddev_sq = 0;
 	uint64_t global_min = UINT64_MAX, global_max = 0;
-	double sum_p50 = 0, sum_p99 = 0;
+	double sum_p50 = 0, sum_p99 = 0, sum_p999 = 0;
 
 	for (int i = 0; i < n; i++) {
 		sum_mean += results[i].mean;
@@ -216,6 +466,9 @@ static struct stat_result stats_merge(struct stat_result *results, int n)
 			global_max = results[i].max;
 		sum_p50 += (double)results[i].p50;
 		sum_p99 += (double)results[i].p99;
+		sum_p999 += (double)results[i].p999;
+		placement_add(&m.place, &results[i].place);
+		perf_add(&m.perf, &results[i].perf, i == 0);
 	}
 
 	m.mean = sum_mean / n;
@@ -224,6 +477,7 @@ static struct stat_result stats_merge(struct stat_result *results, int n)
 	m.max = global_max;
 	m.p50 = (uint64_t)(sum_p50 / n);
 	m.p99 = (uint64_t)(sum_p99 / n);
+	m.p999 = (uint64_t)(sum_p999 / n);
 
 	return m;
 }
@@ -239,8 +493,55 @@ static void stats_print(const char *label, struct stat_result *r, int n_iters)
 	       r->stddev, ops_sec);
 }
 
-static void print_comparison(struct stat_result *on, struct stat_result *off,
-			     int n_iters)
+static double placement_pct(uint64_t n, const struct placement *p)
+{
+	return p->total ? 100.0 * (double)n / (double)p->total : 0.0;
+}
+
+#define PLACEMENT_ROWS(X)			\
+	X("same CPU",      same_cpu)		\
+	X("busy CPU",      busy_cpu)		\
+	X("SMT of busy",   smt_busy)		\
+	X("same cluster",  same_cluster)	\
+	X("other cluster", other_cluster)	\
+	X("collided",      collided)
+
+static void placement_print(const struct placement *p)
+{
+	printf("  placement:");
+#define X(label, field) \
+	printf("  %s %.1f%%", label, placement_pct(p->field, p));
+	PLACEMENT_ROWS(X)
+#undef X
+	printf("\n");
+}
+
+#define PERF_ROWS(X)						\
+	X(PERF_CYCLES,     "cycles",        "%.0f")		\
+	X(PERF_KCYCLES,    "kernel cycles", "%.0f")		\
+	X(PERF_CSW,        "ctx switches",  "%.3f")		\
+	X(PERF_MIGRATIONS, "migrations",    "%.3f")		\
+	X(PERF_LLC_MISSES, "LLC misses",    "%.2f")
+
+static double perf_per_wakeup(const struct perf_counts *p, int counter)
+{
+	return p->wakeups ? (double)p->val[counter] / (double)p->wakeups : 0.0;
+}
+
+static void perf_print(const struct perf_counts *p)
+{
+	printf("  per wakeup:");
+#define X(counter, label, fmt)					\
+	if (p->valid[counter])					\
+		printf("  %s " fmt, label, perf_per_wakeup(p, counter)); \
+	else							\
+		printf("  %s n/a", label);
+	PERF_ROWS(X)
+#undef X
+	printf("\n");
+}
+
+static void print_comparison(struct stat_result *on, struct stat_result *off)
 {
 	double ops_on  = 1e9 / on->mean;
 	double ops_off = 1e9 / off->mean;
@@ -254,15 +555,126 @@ static void print_comparison(struct stat_result *on, struct stat_result *off,
 	       (unsigned long)on->p99, (unsigned long)off->p99);
 	printf("  %-18s %10.0f    %10.0f     %+.1f%%\n", "ops/sec",
 	       ops_on, ops_off, (ops_on - ops_off) / ops_off * 100);
+
+	printf("\n  %-18s %12s %12s\n", "wakee landed on", "POC ON", "POC OFF");
+#define X(label, field)						\
+	printf("  %-18s %11.1f%% %11.1f%%\n", label,		\
+	       placement_pct(on->place.field, &on->place),	\
+	       placement_pct(off->place.field, &off->place));
+	PLACEMENT_ROWS(X)
+#undef X
+
+	printf("\n  %-18s %12s %12s\n", "per wakeup", "POC ON", "POC OFF");
+#define X(counter, label, fmt)						\
+	if (on->perf.valid[counter] && off->perf.valid[counter]) {	\
+		double v_on = perf_per_wakeup(&on->perf, counter);	\
+		double v_off = perf_per_wakeup(&off->perf, counter);	\
+		printf("  %-18s %12.3f %12.3f", label, v_on, v_off);	\
+		if (v_off > 0)						\
+			printf("   %+.1f%%", (v_on - v_off) / v_off * 100); \
+		printf("\n");						\
+	} else {							\
+		printf("  %-18s %12s %12s\n", label, "n/a", "n/a");	\
+	}
+	PERF_ROWS(X)
+#undef X
 }
 
+/* ------------------------------------------------------------------ */
+/*  perf_event counters                                                */
+/* ------------------------------------------------------------------ */
+
+/*
+ * Every thread that wakes or is woken -- not the background burners,
+ * which would drown everything in spin cycles -- opens one counter
+ * group, disabled, and enables it only across its wake syscall (the
+ * waker: write(), FUTEX_WAKE) or its wait syscall (the wakee: read(),
+ * FUTEX_WAIT), adding its totals here at exit.  Pacing sleeps, the
+ * sched_yield() spin until a round is done and the workers' busy loop
+ * stay outside, so kernel cycles are the waker's select_task_rq() (and
+ * thus the selector) plus the wakee's side of the switch, and the
+ * switches are the wakees blocking.  The enable and disable ioctls add
+ * a constant of their own, equal for both sides.  A counter the kernel
+ * refuses (perf_event_paranoid, no PMU in a VM) is reported as n/a.
+ */
+static const struct {
+	uint32_t type;
+	uint64_t config;
+	bool     kernel_only;
+} perf_events[NR_PERF] = {
+	[PERF_CYCLES]     = { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES,     false },
+	[PERF_KCYCLES]    = { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES,     true },
+	[PERF_CSW]        = { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES, false },
+	[PERF_MIGRATIONS] = { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS, false },
+	[PERF_LLC_MISSES] = { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES,   false },
+};
+
+static _Atomic uint64_t perf_sum[NR_PERF];
+static atomic_int       perf_failed[NR_PERF];
+
+struct perf_thread {
+	int fd[NR_PERF];
+	int leader;		/* first counter opened, -1 if none */
+};
+
+static void perf_thread_begin(struct perf_thread *pt)
+{
+	pt->leader = -1;
+	for (int i = 0; i < NR_PERF; i++) {
+		struct perf_event_attr attr = {
+			.type		= perf_events[i].type,
+			.size		= sizeof(attr),
+			.config		= perf_events[i].config,
+			.disabled	= 1,
+			.exclude_user	= perf_events[i].kernel_only,
+			.exclude_hv	= 1,
+		};
+		pt->fd[i] = syscall(SYS_perf_event_open, &attr, 0, -1,
+				    pt->leader, 0);
+		if (pt->fd[i] < 0)
+			atomic_fetch_add(&perf_failed[i], 1);
+		else if (pt->leader < 0)
+			pt->leader = pt->fd[i];
+	}
+}
+
+/* Count across one wake or wait syscall: one ioctl for the whole group */
+static inline void perf_thread_enable(struct perf_thread *pt)
+{
+	if (pt->leader >= 0)
+		ioctl(pt->leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+static inline void perf_thread_disable(struct perf_thread *pt)
+{
+	if (pt->leader >= 0)
+		ioctl(pt->leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+}
+
+static void perf_thread_end(struct perf_thread *pt)
+{
+	for (int i = 0; i < NR_PERF; i++) {
+		uint64_t v;
+		if (pt->fd[i] < 0)
+			continue;
+		if (read(pt->fd[i], &v, sizeof(v)) == (ssize_t)sizeof(v))
+			atomic_fetch_add(&perf_sum[i], v);
+		close(pt->fd[i]);
+	}
+}
+
+
 /* ------------------------------------------------------------------ */
 /*  sysctl helpers                                                     */
 /* ------------------------------------------------------------------ */
 
-static int poc_selector_read(void)
+/* Sysctl toggled by the ON/OFF comparison (--knob) */
+static const char *knob_name = DEFAULT_KNOB;
+static char knob_path[256] = SYSCTL_DIR DEFAULT_KNOB;
+
+static int sysctl_read(const char *path)
 {
-	FILE *f = fopen(SYSCTL_PATH, "r");
+	FILE *f = fopen(path, "r");
 	if (!f)
 		return -1;
 	int val = -1;
@@ -272,20 +684,31 @@ static int poc_selector_read(void)
 	return val;
 }
 
-static int poc_selector_write(int val)
+static int sysctl_write(const char *path, int val)
 {
-	FILE *f = fopen(SYSCTL_PATH, "w");
+	FILE *f = fopen(path, "w");
 	if (!f)
 		return -1;
 	fprintf(f, "%d\n", val);
-	fclose(f);
+	if (fclose(f) != 0)
+		return -1;
 	/* Allow kernel state to settle */
 	usleep(50000);
 	return 0;
 }
 
+static int poc_selector_read(void)
+{
+	return sysctl_read(knob_path);
+}
+
+static int poc_selector_write(int val)
+{
+	return sysctl_write(knob_path, val);
+}
+
 /* ------------------------------------------------------------------ */
-/*  Benchmark: Burst wakeup with background CPU load                   */
+/*  Background load                                                    */
 /* ------------------------------------------------------------------ */
 
 static atomic_int bg_stop;
@@ -306,70 +729,303 @@ static void *bg_burn_fn(void *arg)
 	return NULL;
 }
 
-struct burst_worker_ctx {
-	int       iterations;
+struct bg_load {
+	int        n;
+	int       *cpus;
+	pthread_t *threads;
+};
+
+/*
+ * Burn threads pinned to CPUs first..first+n-1 (at most nproc - 1 of
+ * them; first is 1 when the dispatcher owns CPU 0)
+ */
+static struct bg_load bg_start(int n_background, int first)
+{
+	int ncpus = get_nprocs();
+	struct bg_load bg;
+
+	/* Clamp background threads to available CPUs */
+	if (n_background > ncpus - 1)
+		n_background = ncpus - 1;
+	if (first + n_background > ncpus)
+		first = ncpus - n_background;
+	if (n_background < 0)
+		n_background = 0;
+
+	atomic_store(&bg_stop, 0);
+	bg.n = n_background;
+	bg.cpus = calloc(n_background, sizeof(int));
+	bg.threads = calloc(n_background, sizeof(pthread_t));
+	if (n_background && (!bg.cpus || !bg.threads)) {
+		perror("calloc");
+		exit(1);
+	}
+	for (int i = 0; i < n_background; i++) {
+		bg.cpus[i] = first + i;
+		pthread_create(&bg.threads[i], NULL, bg_burn_fn, &bg.cpus[i]);
+	}
+
+	/* Let background threads settle */
+	usleep(50000);
+	return bg;
+}
+
+static void bg_finish(struct bg_load *bg)
+{
+	atomic_store(&bg_stop, 1);
+	for (int i = 0; i < bg->n; i++)
+		pthread_join(bg->threads[i], NULL);
+}
+
+static void bg_free(struct bg_load *bg)
+{
+	free(bg->cpus);
+	free(bg->threads);
+}
+
+/* ------------------------------------------------------------------ */
+/*  Wakeup log: latency and landing CPU of every measured wakeup       */
+/* ------------------------------------------------------------------ */
+
+/*
+ * One per woken thread.  Round i of every log is the same dispatch
+ * round, so placement_compute() can spot two wakees of one round
+ * landing on the same CPU.
+ */
+struct wake_log {
 	int       warmup;
-	int       efd;
+	int       iterations;
+	int       last_cpu;
 	uint64_t *latencies;
-	uint64_t *ts_wake;
-	atomic_int ready;
+	int      *wake_cpu;	/* CPU of each measured wakeup */
+	int      *prev_cpu;	/* and of the wakeup before it */
+	bool      in_arena;
 };
 
+/* Bytes wake_log_init() takes from an arena */
+static size_t wake_log_arena_size(int iterations)
+{
+	return 3 * CACHELINE +
+	       (size_t)iterations * (sizeof(uint64_t) + 2 * sizeof(int));
+}
+
+/* @arena may be NULL: plain heap buffers */
+static void wake_log_init(struct wake_log *log, int warmup, int iterations,
+			  struct arena *arena)
+{
+	log->warmup = warmup;
+	log->iterations = iterations;
+	log->last_cpu = -1;
+	log->in_arena = arena;
+	if (arena) {
+		log->latencies = arena_alloc(arena, iterations * sizeof(uint64_t));
+		log->wake_cpu = arena_alloc(arena, iterations * sizeof(int));
+		log->prev_cpu = arena_alloc(arena, iterations * sizeof(int));
+		return;
+	}
+	log->latencies = calloc(iterations, sizeof(uint64_t));
+	log->wake_cpu = calloc(iterations, sizeof(int));
+	log->prev_cpu = calloc(iterations, sizeof(int));
+	if (!log->latencies || !log->wake_cpu || !log->prev_cpu) {
+		perror("calloc");
+		exit(1);
+	}
+}
+
+/* Right after the wakee returns from its blocking call for round @i */
+static void wake_log_record(struct wake_log *log, int i, uint64_t t0)
+{
+	uint64_t t1 = now_ns();
+	int cpu = sched_getcpu();
+
+	if (i >= log->warmup) {
+		log->latencies[i - log->warmup] = t1 - t0;
+		log->wake_cpu[i - log->warmup] = cpu;
+		log->prev_cpu[i - log->warmup] = log->last_cpu;
+	}
+	log->last_cpu = cpu;
+}
+
+static void wake_log_free(struct wake_log *log)
+{
+	if (log->in_arena)
+		return;
+	free(log->latencies);
+	free(log->wake_cpu);
+	free(log->prev_cpu);
+}
+
+static struct placement placement_compute(struct wake_log **logs, int n_logs,
+					  int iterations,
+					  const struct bg_load *bg)
+{
+	struct placement p = {0};
+	bool *busy = calloc(nr_cpu_ids, sizeof(bool));
+	bool *smt_busy = calloc(nr_cpu_ids, sizeof(bool));
+	int *round_hits = calloc(nr_cpu_ids, sizeof(int));
+	if (!busy || !smt_busy || !round_hits) {
+		perror("calloc");
+		exit(1);
+	}
+
+	for (int b = 0; b < bg->n; b++)
+		busy[bg->cpus[b]] = true;
+	for (int c = 0; c < nr_cpu_ids; c++)
+		for (int b = 0; b < bg->n; b++)
+			if (bg->cpus[b] != c &&
+			    cpu_topo[bg->cpus[b]].core == cpu_topo[c].core)
+				smt_busy[c] = true;
+
+	for (int i = 0; i < iterations; i++) {
+		for (int w = 0; w < n_logs; w++) {
+			int cpu = logs[w]->wake_cpu[i];
+			if (cpu >= 0 && cpu < nr_cpu_ids)
+				round_hits[cpu]++;
+		}
+		for (int w = 0; w < n_logs; w++) {
+			int cpu = logs[w]->wake_cpu[i];
+			int prev = logs[w]->prev_cpu[i];
+			if (cpu < 0 || cpu >= nr_cpu_ids ||
+			    prev < 0 || prev >= nr_cpu_ids)
+				continue;
+
+			p.total++;
+			if (cpu == prev)
+				p.same_cpu++;
+			else if (busy[cpu])
+				p.busy_cpu++;
+			else if (smt_busy[cpu])
+				p.smt_busy++;
+			else if (cpu_topo[cpu].cluster == cpu_topo[prev].cluster)
+				p.same_cluster++;
+			else
+				p.other_cluster++;
+			if (round_hits[cpu] > 1)
+				p.collided++;
+		}
+		for (int w = 0; w < n_logs; w++) {
+			int cpu = logs[w]->wake_cpu[i];
+			if (cpu >= 0 && cpu < nr_cpu_ids)
+				round_hits[cpu] = 0;
+		}
+	}
+
+	free(busy);
+	free(smt_busy);
+	free(round_hits);
+	return p;
+}
+
+/* Latency statistics over all logs, plus their placement */
+static struct stat_result wake_logs_result(struct wake_log **logs, int n_logs,
+					   int iterations,
+					   const struct bg_load *bg)
+{
+	int n_total = iterations * n_logs;
+	uint64_t *all = calloc(n_total, sizeof(uint64_t));
+	if (!all) {
+		perror("calloc");
+		exit(1);
+	}
+	int idx = 0;
+	for (int w = 0; w < n_logs; w++)
+		for (int i = 0; i < iterations; i++)
+			all[idx++] = logs[w]->latencies[i];
+
+	struct stats st = { .samples = all, .n = n_total };
+	struct stat_result r = stats_compute(&st);
+	r.place = placement_compute(logs, n_logs, iterations, bg);
+	for (int w = 0; w < n_logs; w++)
+		r.perf.wakeups += logs[w]->warmup + logs[w]->iterations;
+
+	free(all);
+	return r;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Benchmark: Burst wakeup with background CPU load                   */
+/* ------------------------------------------------------------------ */
+
+/*
+ * One cache line (or more) per worker, so the dispatcher's stores to one
+ * worker do not bounce another worker's line
+ */
+struct burst_worker_ctx {
+	int         efd;
+	uint64_t   *ts_wake;
+	atomic_int *round_done;	/* --precise: workers done with the round */
+	struct wake_log log;
+	atomic_int  ready;
+} __attribute__((aligned(CACHELINE)));
+
 static void *burst_worker_fn(void *arg)
 {
 	struct burst_worker_ctx *w = arg;
-	int total = w->warmup + w->iterations;
+	int total = w->log.warmup + w->log.iterations;
+	struct perf_thread pt;
 
+	perf_thread_begin(&pt);
+	w->log.last_cpu = sched_getcpu();
 	atomic_store(&w->ready, 1);
 
 	for (int i = 0; i < total; i++) {
 		uint64_t val;
-		if (read(w->efd, &val, sizeof(val)) != (ssize_t)sizeof(val))
+		perf_thread_enable(&pt);
+		ssize_t n = read(w->efd, &val, sizeof(val));
+		perf_thread_disable(&pt);
+		if (n != (ssize_t)sizeof(val))
 			break;
-		uint64_t t1 = now_ns();
-		uint64_t t0 = __atomic_load_n(&w->ts_wake[i], __ATOMIC_ACQUIRE);
-		if (i >= w->warmup)
-			w->latencies[i - w->warmup] = t1 - t0;
+		wake_log_record(&w->log, i,
+				__atomic_load_n(&w->ts_wake[i], __ATOMIC_ACQUIRE));
 		/* Brief computation to simulate real work */
 		volatile int x = 0;
 		for (int j = 0; j < 100; j++)
 			x += j;
+		if (w->round_done)
+			atomic_fetch_add_explicit(w->round_done, 1,
+						  memory_order_release);
 	}
+	perf_thread_end(&pt);
 	return NULL;
 }
 
+/*
+ * --precise: the dispatcher owns CPU 0 at SCHED_FIFO (background load
+ * moves to CPUs 1..n), waits until every worker has finished the round,
+ * spins for @gap_ns on the TSC and timestamps each write separately --
+ * the Rust benchmark's dispatch loop.  All measured buffers come from
+ * one locked arena.  Otherwise the dispatcher is an ordinary thread that
+ * nanosleep()s @gap_ns between rounds.
+ */
 static struct stat_result bench_burst(int n_workers, int n_background,
-				      int iterations, int warmup)
+				      int iterations, int warmup,
+				      bool precise, uint64_t gap_ns)
 {
-	int ncpus = get_nprocs();
 	int total = warmup + iterations;
-
-	/* Clamp background threads to available CPUs */
-	if (n_background > ncpus - 1)
-		n_background = ncpus - 1;
-	if (n_background < 0)
-		n_background = 0;
+	struct arena arena = { 0 };
+	atomic_int *round_done = NULL;
+	struct burst_worker_ctx *workers;
 
 	/* Start background load threads pinned to specific CPUs */
-	atomic_store(&bg_stop, 0);
-	int *bg_cpus = calloc(n_background, sizeof(int));
-	pthread_t *bg_threads = calloc(n_background, sizeof(pthread_t));
-	if (!bg_cpus || !bg_threads) {
-		perror("calloc");
-		exit(1);
-	}
-	for (int i = 0; i < n_background; i++) {
-		bg_cpus[i] = i;  /* Pin to CPUs 0..n_background-1 */
-		pthread_create(&bg_threads[i], NULL, bg_burn_fn, &bg_cpus[i]);
+	struct bg_load bg = bg_start(n_background, precise ? 1 : 0);
+
+	if (precise) {
+		arena_init(&arena, CACHELINE + n_workers *
+			   (sizeof(*workers) + wake_log_arena_size(iterations) +
+			    CACHELINE + (size_t)total * sizeof(uint64_t)));
+		round_done = arena_alloc(&arena, sizeof(*round_done));
+		atomic_init(round_done, 0);
+		workers = arena_alloc(&arena, n_workers * sizeof(*workers));
+	} else {
+		workers = aligned_alloc(CACHELINE, n_workers * sizeof(*workers));
+		if (workers)
+			memset(workers, 0, n_workers * sizeof(*workers));
 	}
 
-	/* Let background threads settle */
-	usleep(50000);
-
 	/* Start worker threads (not pinned — let scheduler choose) */
-	struct burst_worker_ctx *workers = calloc(n_workers, sizeof(*workers));
 	pthread_t *worker_threads = calloc(n_workers, sizeof(pthread_t));
-	if (!workers || !worker_threads) {
+	struct wake_log **logs = calloc(n_workers, sizeof(*logs));
+	if (!workers || !worker_threads || !logs) {
 		perror("calloc");
 		exit(1);
 	}
@@ -379,12 +1035,15 @@ static struct stat_result bench_burst(int n_workers, int n_background,
 			perror("eventfd");
 			exit(1);
 		}
-		workers[i].iterations = iterations;
-		workers[i].warmup = warmup;
-		workers[i].latencies = calloc(iterations, sizeof(uint64_t));
-		workers[i].ts_wake = calloc(total, sizeof(uint64_t));
+		wake_log_init(&workers[i].log, warmup, iterations,
+			      precise ? &arena : NULL);
+		logs[i] = &workers[i].log;
+		workers[i].ts_wake = precise ?
+			arena_alloc(&arena, total * sizeof(uint64_t)) :
+			calloc(total, sizeof(uint64_t));
+		workers[i].round_done = round_done;
 		atomic_init(&workers[i].ready, 0);
-		if (!workers[i].latencies || !workers[i].ts_wake) {
+		if (!workers[i].ts_wake) {
 			perror("calloc");
 			exit(1);
 		}
@@ -396,56 +1055,426 @@ static struct stat_result bench_burst(int n_workers, int n_background,
 		while (!atomic_load(&workers[i].ready))
 			usleep(100);
 
+	struct saved_sched sv;
+	if (precise)
+		dispatcher_enter(&sv, 0);
 	usleep(10000);
 
 	/* Dispatch wakeups */
 	uint64_t wval = 1;
+	struct perf_thread pt;
+	perf_thread_begin(&pt);
 	for (int i = 0; i < total; i++) {
+		if (precise && i > 0) {
+			while (atomic_load_explicit(round_done,
+						    memory_order_acquire) < n_workers)
+				cpu_relax();
+			atomic_store_explicit(round_done, 0, memory_order_relaxed);
+			pace_wait_ns(gap_ns);
+		}
+		perf_thread_enable(&pt);
 		uint64_t t0 = now_ns();
 		for (int w = 0; w < n_workers; w++) {
+			if (precise)
+				t0 = now_ns();
 			__atomic_store_n(&workers[w].ts_wake[i], t0,
 					 __ATOMIC_RELEASE);
 			if (write(workers[w].efd, &wval, sizeof(wval)) !=
-			    (ssize_t)sizeof(wval))
-				break;
+			    (ssize_t)sizeof(wval)) {
+				perf_thread_disable(&pt);
+				goto out;
+			}
+		}
+		perf_thread_disable(&pt);
+		if (!precise) {
+			struct timespec ts = { .tv_nsec = (long)gap_ns };
+			nanosleep(&ts, NULL);
 		}
-		struct timespec ts = { .tv_nsec = 1000 };
-		nanosleep(&ts, NULL);
 	}
+out:
+	perf_thread_end(&pt);
 
 	for (int i = 0; i < n_workers; i++)
 		pthread_join(worker_threads[i], NULL);
+	if (precise)
+		dispatcher_leave(&sv);
 
 	/* Stop background load */
-	atomic_store(&bg_stop, 1);
-	for (int i = 0; i < n_background; i++)
-		pthread_join(bg_threads[i], NULL);
+	bg_finish(&bg);
 
 	/* Aggregate */
-	int n_total = iterations * n_workers;
-	uint64_t *all = calloc(n_total, sizeof(uint64_t));
-	if (!all) {
+	struct stat_result r = wake_logs_result(logs, n_workers, iterations, &bg);
+
+	for (int i = 0; i < n_workers; i++) {
+		close(workers[i].efd);
+		wake_log_free(&workers[i].log);
+		if (!precise)
+			free(workers[i].ts_wake);
+	}
+	if (precise)
+		arena_free(&arena);
+	else
+		free(workers);
+	free(worker_threads);
+	free(logs);
+	bg_free(&bg);
+	return r;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Benchmark: Pipe ping-pong (synchronous request/response)           */
+/* ------------------------------------------------------------------ */
+
+/*
+ * Pairs of threads bouncing a timestamp over two pipes.  A pipe write
+ * wakes the reader with WF_SYNC, the path kernel.sched_poc_sync_affinity
+ * acts on.  Both directions are measured: one sample per half trip.
+ */
+struct pipe_side {
+	int       rfd;
+	int       wfd;
+	bool      initiator;
+	struct wake_log log;
+};
+
+static void *pipe_side_fn(void *arg)
+{
+	struct pipe_side *s = arg;
+	int total = s->log.warmup + s->log.iterations;
+	struct perf_thread pt;
+	uint64_t t0;
+
+	perf_thread_begin(&pt);
+	s->log.last_cpu = sched_getcpu();
+	for (int i = 0; i < total; i++) {
+		/* The window spans the request and the response */
+		perf_thread_enable(&pt);
+		if (s->initiator) {
+			t0 = now_ns();
+			if (write(s->wfd, &t0, sizeof(t0)) != (ssize_t)sizeof(t0))
+				break;
+		}
+		if (read(s->rfd, &t0, sizeof(t0)) != (ssize_t)sizeof(t0))
+			break;
+		wake_log_record(&s->log, i, t0);
+		if (!s->initiator) {
+			t0 = now_ns();
+			if (write(s->wfd, &t0, sizeof(t0)) != (ssize_t)sizeof(t0))
+				break;
+		}
+		perf_thread_disable(&pt);
+		if (s->initiator) {
+			/* Think time: the responder goes back to sleep */
+			struct timespec ts = { .tv_nsec = 1000 };
+			nanosleep(&ts, NULL);
+		}
+	}
+	perf_thread_end(&pt);
+	return NULL;
+}
+
+static struct stat_result bench_pipe(int n_pairs, int n_background,
+				     int iterations, int warmup)
+{
+	struct bg_load bg = bg_start(n_background, 0);
+	int n_sides = 2 * n_pairs;
+	struct pipe_side *sides = calloc(n_sides, sizeof(*sides));
+	pthread_t *threads = calloc(n_sides, sizeof(pthread_t));
+	struct wake_log **logs = calloc(n_sides, sizeof(*logs));
+	if (!sides || !threads || !logs) {
 		perror("calloc");
 		exit(1);
 	}
-	int idx = 0;
-	for (int w = 0; w < n_workers; w++)
-		for (int i = 0; i < iterations; i++)
-			all[idx++] = workers[w].latencies[i];
 
-	struct stats st = { .samples = all, .n = n_total };
-	struct stat_result r = stats_compute(&st);
+	for (int p = 0; p < n_pairs; p++) {
+		int ab[2], ba[2];
+		if (pipe(ab) < 0 || pipe(ba) < 0) {
+			perror("pipe");
+			exit(1);
+		}
+		struct pipe_side *a = &sides[2 * p], *b = &sides[2 * p + 1];
+		a->initiator = true;
+		a->wfd = ab[1];
+		b->rfd = ab[0];
+		b->wfd = ba[1];
+		a->rfd = ba[0];
+	}
+	for (int i = 0; i < n_sides; i++) {
+		wake_log_init(&sides[i].log, warmup, iterations, NULL);
+		logs[i] = &sides[i].log;
+	}
+	/* Responders first, so that every first request finds a reader */
+	for (int i = n_sides - 1; i >= 0; i--)
+		pthread_create(&threads[i], NULL, pipe_side_fn, &sides[i]);
+	for (int i = 0; i < n_sides; i++)
+		pthread_join(threads[i], NULL);
+
+	bg_finish(&bg);
+	struct stat_result r = wake_logs_result(logs, n_sides, iterations, &bg);
+
+	for (int i = 0; i < n_sides; i++) {
+		close(sides[i].rfd);
+		close(sides[i].wfd);
+		wake_log_free(&sides[i].log);
+	}
+	free(sides);
+	free(threads);
+	free(logs);
+	bg_free(&bg);
+	return r;
+}
 
-	for (int i = 0; i < n_workers; i++) {
-		close(workers[i].efd);
-		free(workers[i].latencies);
-		free(workers[i].ts_wake);
+/* ------------------------------------------------------------------ */
+/*  Benchmark: Futex wake-many (thread pool)                           */
+/* ------------------------------------------------------------------ */
+
+/*
+ * A pool of waiters parked on one futex word; every round the
+ * dispatcher bumps it and wakes them all with a single FUTEX_WAKE, the
+ * burst that kernel.sched_poc_wake_batch and kernel.sched_poc_claim are
+ * for.
+ */
+struct futex_pool {
+	_Atomic uint32_t seq;
+	_Atomic uint64_t ts_wake;
+	atomic_int       done;	/* waiters finished with the current round */
+};
+
+struct futex_waiter {
+	struct futex_pool *pool;
+	struct wake_log    log;
+};
+
+static long futex_op(_Atomic uint32_t *uaddr, int op, uint32_t val)
+{
+	return syscall(SYS_futex, uaddr, op | FUTEX_PRIVATE_FLAG, val,
+		       NULL, NULL, 0);
+}
+
+static void *futex_waiter_fn(void *arg)
+{
+	struct futex_waiter *w = arg;
+	struct futex_pool *pool = w->pool;
+	int total = w->log.warmup + w->log.iterations;
+	struct perf_thread pt;
+
+	perf_thread_begin(&pt);
+	w->log.last_cpu = sched_getcpu();
+	for (int i = 0; i < total; i++) {
+		atomic_fetch_add(&pool->done, 1);
+		perf_thread_enable(&pt);
+		while (atomic_load(&pool->seq) == (uint32_t)i)
+			futex_op(&pool->seq, FUTEX_WAIT, (uint32_t)i);
+		perf_thread_disable(&pt);
+		wake_log_record(&w->log, i, atomic_load(&pool->ts_wake));
 	}
-	free(workers);
-	free(worker_threads);
-	free(bg_cpus);
-	free(bg_threads);
-	free(all);
+	perf_thread_end(&pt);
+	return NULL;
+}
+
+static struct stat_result bench_futex(int n_waiters, int n_background,
+				      int iterations, int warmup)
+{
+	int total = warmup + iterations;
+	struct bg_load bg = bg_start(n_background, 0);
+	struct futex_pool pool = { 0 };
+	struct futex_waiter *waiters = calloc(n_waiters, sizeof(*waiters));
+	pthread_t *threads = calloc(n_waiters, sizeof(pthread_t));
+	struct wake_log **logs = calloc(n_waiters, sizeof(*logs));
+	if (!waiters || !threads || !logs) {
+		perror("calloc");
+		exit(1);
+	}
+
+	for (int i = 0; i < n_waiters; i++) {
+		waiters[i].pool = &pool;
+		wake_log_init(&waiters[i].log, warmup, iterations, NULL);
+		logs[i] = &waiters[i].log;
+		pthread_create(&threads[i], NULL, futex_waiter_fn, &waiters[i]);
+	}
+
+	struct perf_thread pt;
+	perf_thread_begin(&pt);
+	for (int i = 0; i < total; i++) {
+		/* Every waiter back in (or on its way into) FUTEX_WAIT */
+		while (atomic_load(&pool.done) < n_waiters)
+			sched_yield();
+		atomic_store(&pool.done, 0);
+		usleep(10);
+
+		perf_thread_enable(&pt);
+		atomic_store(&pool.ts_wake, now_ns());
+		atomic_store(&pool.seq, (uint32_t)i + 1);
+		futex_op(&pool.seq, FUTEX_WAKE, INT_MAX);
+		perf_thread_disable(&pt);
+	}
+	perf_thread_end(&pt);
+
+	for (int i = 0; i < n_waiters; i++)
+		pthread_join(threads[i], NULL);
+
+	bg_finish(&bg);
+	struct stat_result r = wake_logs_result(logs, n_waiters, iterations, &bg);
+
+	for (int i = 0; i < n_waiters; i++)
+		wake_log_free(&waiters[i].log);
+	free(waiters);
+	free(threads);
+	free(logs);
+	bg_free(&bg);
+	return r;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Benchmark: Socket fan-out (hackbench-style)                        */
+/* ------------------------------------------------------------------ */
+
+/*
+ * Groups of one sender and N receivers, each receiver on its own
+ * AF_UNIX socketpair.  Every round the sender writes one timestamped
+ * message to each of its receivers back to back, so the wakeups of a
+ * group -- and of all groups -- race for the same idle CPUs.
+ */
+struct fanout_group {
+	int        n_receivers;
+	int       *sock;	/* sender ends */
+	atomic_int done;
+	int        iterations;
+	int        warmup;
+};
+
+struct fanout_receiver {
+	struct fanout_group *group;
+	int                  sock;
+	struct wake_log      log;
+};
+
+static void *fanout_receiver_fn(void *arg)
+{
+	struct fanout_receiver *r = arg;
+	int total = r->log.warmup + r->log.iterations;
+	struct perf_thread pt;
+	uint64_t t0;
+
+	perf_thread_begin(&pt);
+	r->log.last_cpu = sched_getcpu();
+	for (int i = 0; i < total; i++) {
+		atomic_fetch_add(&r->group->done, 1);
+		perf_thread_enable(&pt);
+		ssize_t n = read(r->sock, &t0, sizeof(t0));
+		perf_thread_disable(&pt);
+		if (n != (ssize_t)sizeof(t0))
+			break;
+		wake_log_record(&r->log, i, t0);
+	}
+	perf_thread_end(&pt);
+	return NULL;
+}
+
+static void *fanout_sender_fn(void *arg)
+{
+	struct fanout_group *g = arg;
+	int total = g->warmup + g->iterations;
+	struct perf_thread pt;
+
+	perf_thread_begin(&pt);
+	for (int i = 0; i < total; i++) {
+		while (atomic_load(&g->done) < g->n_receivers)
+			sched_yield();
+		atomic_store(&g->done, 0);
+		usleep(10);
+
+		perf_thread_enable(&pt);
+		for (int r = 0; r < g->n_receivers; r++) {
+			uint64_t t0 = now_ns();
+			if (write(g->sock[r], &t0, sizeof(t0)) !=
+			    (ssize_t)sizeof(t0)) {
+				perf_thread_disable(&pt);
+				goto out;
+			}
+		}
+		perf_thread_disable(&pt);
+	}
+out:
+	perf_thread_end(&pt);
+	return NULL;
+}
+
+static struct stat_result bench_fanout(int n_receivers, int n_groups,
+				       int n_background, int iterations,
+				       int warmup)
+{
+	struct bg_load bg = bg_start(n_background, 0);
+
+	if (n_groups < 1)
+		n_groups = 1;
+	if (n_groups > n_receivers)
+		n_groups = n_receivers;
+
+	struct fanout_group *groups = calloc(n_groups, sizeof(*groups));
+	struct fanout_receiver *recv = calloc(n_receivers, sizeof(*recv));
+	pthread_t *senders = calloc(n_groups, sizeof(pthread_t));
+	pthread_t *threads = calloc(n_receivers, sizeof(pthread_t));
+	struct wake_log **logs = calloc(n_receivers, sizeof(*logs));
+	if (!groups || !recv || !senders || !threads || !logs) {
+		perror("calloc");
+		exit(1);
+	}
+
+	/* Receivers dealt round-robin over the groups */
+	for (int g = 0; g < n_groups; g++) {
+		groups[g].n_receivers = n_receivers / n_groups +
+					(g < n_receivers % n_groups);
+		groups[g].sock = calloc(groups[g].n_receivers, sizeof(int));
+		groups[g].iterations = iterations;
+		groups[g].warmup = warmup;
+		atomic_init(&groups[g].done, 0);
+		if (!groups[g].sock) {
+			perror("calloc");
+			exit(1);
+		}
+	}
+	for (int i = 0; i < n_receivers; i++) {
+		struct fanout_group *g = &groups[i % n_groups];
+		int sv[2];
+		if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) < 0) {
+			perror("socketpair");
+			exit(1);
+		}
+		g->sock[i / n_groups] = sv[0];
+		recv[i].group = g;
+		recv[i].sock = sv[1];
+		wake_log_init(&recv[i].log, warmup, iterations, NULL);
+		logs[i] = &recv[i].log;
+		pthread_create(&threads[i], NULL, fanout_receiver_fn, &recv[i]);
+	}
+	for (int g = 0; g < n_groups; g++)
+		pthread_create(&senders[g], NULL, fanout_sender_fn, &groups[g]);
+
+	for (int g = 0; g < n_groups; g++)
+		pthread_join(senders[g], NULL);
+	for (int i = 0; i < n_receivers; i++)
+		pthread_join(threads[i], NULL);
+
+	bg_finish(&bg);
+	struct stat_result r = wake_logs_result(logs, n_receivers, iterations,
+						&bg);
+
+	for (int i = 0; i < n_receivers; i++) {
+		close(recv[i].sock);
+		wake_log_free(&recv[i].log);
+	}
+	for (int g = 0; g < n_groups; g++) {
+		for (int r = 0; r < groups[g].n_receivers; r++)
+			close(groups[g].sock[r]);
+		free(groups[g].sock);
+	}
+	free(groups);
+	free(recv);
+	free(senders);
+	free(threads);
+	free(logs);
+	bg_free(&bg);
 	return r;
 }
 
@@ -459,9 +1488,28 @@ struct run_config {
 	int warmup;
 	int n_threads;
 	int n_background;
+	int n_groups;
 	bool compare;
+	bool precise;
+	uint64_t gap_ns;
 };
 
+/* One benchmark run, with the counters of its threads */
+static struct stat_result run_counted(struct stat_result (*fn)(struct run_config *),
+				      struct run_config *cfg)
+{
+	for (int i = 0; i < NR_PERF; i++) {
+		atomic_store(&perf_sum[i], 0);
+		atomic_store(&perf_failed[i], 0);
+	}
+	struct stat_result r = fn(cfg);
+	for (int i = 0; i < NR_PERF; i++) {
+		r.perf.val[i] = atomic_load(&perf_sum[i]);
+		r.perf.valid[i] = !atomic_load(&perf_failed[i]);
+	}
+	return r;
+}
+
 static void run_scenario(const char *title, struct run_config *cfg,
 			 struct stat_result (*fn)(struct run_config *))
 {
@@ -472,8 +1520,10 @@ static void run_scenario(const char *title, struct run_config *cfg,
 		       cfg->iterations, cfg->warmup);
 		if (orig_poc < 0)
 			printf("  [sysctl not available — running single measurement]\n");
-		struct stat_result r = fn(cfg);
+		struct stat_result r = run_counted(fn, cfg);
 		stats_print("result", &r, cfg->iterations);
+		placement_print(&r.place);
+		perf_print(&r.perf);
 		return;
 	}
 
@@ -482,8 +1532,10 @@ static void run_scenario(const char *title, struct run_config *cfg,
 		printf("\n--- %s (%d iterations, %d warmup) ---\n", title,
 		       cfg->iterations, cfg->warmup);
 		printf("  [cannot toggle sysctl (need root?) — running single measurement]\n");
-		struct stat_result r = fn(cfg);
+		struct stat_result r = run_counted(fn, cfg);
 		stats_print("result", &r, cfg->iterations);
+		placement_print(&r.place);
+		perf_print(&r.perf);
 		return;
 	}
 
@@ -507,7 +1559,7 @@ static void run_scenario(const char *title, struct run_config *cfg,
 		struct stat_result phase[2];
 		for (int ph = 0; ph < 2; ph++) {
 			poc_selector_write(order[ph]);
-			phase[ph] = fn(cfg);
+			phase[ph] = run_counted(fn, cfg);
 		}
 
 		if (round > 0) {
@@ -538,15 +1590,251 @@ static void run_scenario(const char *title, struct run_config *cfg,
 	stats_print("POC ON", &r_on, cfg->iterations);
 	stats_print("POC OFF", &r_off, cfg->iterations);
 	printf("\n");
-	print_comparison(&r_on, &r_off, cfg->iterations);
+	print_comparison(&r_on, &r_off);
 }
 
 static struct stat_result run_burst(struct run_config *cfg)
 {
 	return bench_burst(cfg->n_threads, cfg->n_background,
+			   cfg->iterations, cfg->warmup,
+			   cfg->precise, cfg->gap_ns);
+}
+
+/* Two threads per pair: half as many pairs as threads */
+static struct stat_result run_pipe(struct run_config *cfg)
+{
+	int pairs = cfg->n_threads / 2 > 0 ? cfg->n_threads / 2 : 1;
+
+	return bench_pipe(pairs, cfg->n_background,
+			  cfg->iterations, cfg->warmup);
+}
+
+static struct stat_result run_futex(struct run_config *cfg)
+{
+	return bench_futex(cfg->n_threads, cfg->n_background,
 			   cfg->iterations, cfg->warmup);
 }
 
+static struct stat_result run_fanout(struct run_config *cfg)
+{
+	return bench_fanout(cfg->n_threads, cfg->n_groups, cfg->n_background,
+			    cfg->iterations, cfg->warmup);
+}
+
+struct scenario {
+	const char *name;
+	const char *title;
+	struct stat_result (*fn)(struct run_config *);
+};
+
+static const struct scenario scenarios[] = {
+	{ "burst",  "Burst with Background Load",       run_burst },
+	{ "pipe",   "Pipe Ping-Pong (sync wakeups)",    run_pipe },
+	{ "futex",  "Futex Wake-Many",                  run_futex },
+	{ "fanout", "Socket Fan-Out (hackbench-style)", run_fanout },
+};
+#define NR_SCENARIOS (int)(sizeof(scenarios) / sizeof(scenarios[0]))
+
+/* ------------------------------------------------------------------ */
+/*  Sweep: latency vs. utilization across POC knob combinations        */
+/* ------------------------------------------------------------------ */
+
+/*
+ * Boolean sysctls that change where a CFS wakeup lands; "--sweep-knobs
+ * all" cycles through every combination of them (2^7 configurations
+ * per load point, so expect a long run).
+ */
+static const char *const sweep_knobs_all[] = {
+	"sched_poc_l2_cluster_search",
+	"sched_poc_claim",
+	"sched_poc_sharded",
+	"sched_poc_shallow_idle",
+	"sched_poc_sync_affinity",
+	"sched_poc_sched_idle",
+	"sched_poc_xllc_search",
+};
+#define NR_SWEEP_KNOBS (int)(sizeof(sweep_knobs_all) / sizeof(sweep_knobs_all[0]))
+#define DEFAULT_SWEEP_KNOBS "sched_poc_l2_cluster_search,sched_poc_claim"
+#define DEFAULT_SWEEP_STEPS 4
+#define SWEEP_MAX_THREADS   16
+
+struct sweep {
+	bool        enabled;
+	int         steps;		/* background load 0..100% in @steps */
+	int         threads[SWEEP_MAX_THREADS];
+	int         n_threads;		/* 0 = the -t worker count only */
+	const char *knobs[NR_SWEEP_KNOBS];
+	int         n_knobs;
+	int         orig[NR_SWEEP_KNOBS];
+};
+
+static void sweep_knob_path(char *buf, size_t len, const char *name)
+{
+	snprintf(buf, len, "%s%s", SYSCTL_DIR, name);
+}
+
+/* Knobs the kernel does not have (or we cannot write) are dropped */
+static void sweep_probe_knobs(struct sweep *sw)
+{
+	char path[256];
+	int n = 0;
+
+	for (int i = 0; i < sw->n_knobs; i++) {
+		if (!strcmp(sw->knobs[i], knob_name))
+			continue;	/* already the ON/OFF axis */
+		sweep_knob_path(path, sizeof(path), sw->knobs[i]);
+		int val = sysctl_read(path);
+		if (val < 0 || sysctl_write(path, val) < 0) {
+			printf("  [%s not available — left out of the sweep]\n",
+			       sw->knobs[i]);
+			continue;
+		}
+		sw->orig[n] = val;
+		sw->knobs[n++] = sw->knobs[i];
+	}
+	sw->n_knobs = n;
+}
+
+/*
+ * Configuration 0 is the --knob sysctl off with every sweep knob at its
+ * original value, so the baseline does not inherit the combination the
+ * previous configuration left behind; configuration c > 0 is --knob on
+ * with knob i set to bit i of c - 1.
+ */
+static void sweep_apply(const struct sweep *sw, int config)
+{
+	char path[256];
+
+	if (config == 0) {
+		for (int i = 0; i < sw->n_knobs; i++) {
+			sweep_knob_path(path, sizeof(path), sw->knobs[i]);
+			sysctl_write(path, sw->orig[i]);
+		}
+		poc_selector_write(0);
+		return;
+	}
+	poc_selector_write(1);
+	for (int i = 0; i < sw->n_knobs; i++) {
+		sweep_knob_path(path, sizeof(path), sw->knobs[i]);
+		sysctl_write(path, ((config - 1) >> i) & 1);
+	}
+}
+
+static void sweep_restore(const struct sweep *sw, int orig_poc)
+{
+	char path[256];
+
+	for (int i = 0; i < sw->n_knobs; i++) {
+		sweep_knob_path(path, sizeof(path), sw->knobs[i]);
+		sysctl_write(path, sw->orig[i]);
+	}
+	poc_selector_write(orig_poc);
+}
+
+static void sweep_label(const struct sweep *sw, int config, char *buf,
+			size_t len)
+{
+	int off = snprintf(buf, len, "%s", config ? "on" : "off");
+
+	for (int i = 0; config && i < sw->n_knobs; i++) {
+		if (!(((config - 1) >> i) & 1) || off >= (int)len)
+			continue;
+		const char *name = sw->knobs[i];
+		if (!strncmp(name, "sched_poc_", 10))
+			name += 10;
+		off += snprintf(buf + off, len - off, "+%s", name);
+	}
+}
+
+static void sweep_print_row(int bg, int ncpus, int threads, const char *label,
+			    const struct stat_result *r)
+{
+	printf("  %4d %4.0f%% %4d  %-40s %8lu %8lu %8lu %10.0f",
+	       bg, 100.0 * bg / ncpus, threads, label,
+	       (unsigned long)r->p50, (unsigned long)r->p99,
+	       (unsigned long)r->p999, 1e9 / r->mean);
+	if (r->perf.valid[PERF_KCYCLES])
+		printf(" %9.0f\n", perf_per_wakeup(&r->perf, PERF_KCYCLES));
+	else
+		printf(" %9s\n", "n/a");
+}
+
+/*
+ * Step the background load from 0 to all-but-one CPU (and the worker
+ * count over --sweep-threads), measuring every knob configuration at
+ * each point.  Each point gets a discard run, then COMPARE_ROUNDS rounds
+ * with the configuration order rotated per round so slow drift does not
+ * favour one of them.
+ */
+static void run_sweep(const char *title, struct run_config *base,
+		      struct stat_result (*fn)(struct run_config *),
+		      struct sweep *sw)
+{
+	int ncpus = get_nprocs();
+	int orig_poc = poc_selector_read();
+	bool toggle = orig_poc >= 0 && poc_selector_write(orig_poc) >= 0;
+	int n_configs = toggle ? 1 + (1 << sw->n_knobs) : 1;
+	int n_threads = sw->n_threads ? sw->n_threads : 1;
+	struct run_config cfg = *base;
+	struct stat_result *rounds;
+	char label[128];
+
+	rounds = calloc((size_t)n_configs * COMPARE_ROUNDS, sizeof(*rounds));
+	if (!rounds) {
+		perror("calloc");
+		exit(1);
+	}
+
+	printf("\n--- Sweep: %s (%d iters x %d rounds, %d warmup, "
+	       "%d configs) ---\n", title, cfg.iterations, COMPARE_ROUNDS,
+	       cfg.warmup, n_configs);
+	if (!toggle)
+		printf("  [sysctl not available — sweeping load only]\n");
+	printf("  %4s %5s %4s  %-40s %8s %8s %8s %10s %9s\n", "bg", "load",
+	       "thr", "config", "p50 ns", "p99 ns", "p99.9 ns", "ops/s",
+	       "kcyc/wk");
+
+	for (int t = 0; t < n_threads; t++) {
+		cfg.n_threads = sw->n_threads ? sw->threads[t] : base->n_threads;
+		int last_bg = -1;
+
+		for (int step = 0; step <= sw->steps; step++) {
+			int bg = step * (ncpus - 1) / sw->steps;
+			if (bg == last_bg)
+				continue;
+			last_bg = bg;
+			cfg.n_background = bg;
+
+			fn(&cfg);	/* discard */
+			for (int round = 0; round < COMPARE_ROUNDS; round++) {
+				for (int k = 0; k < n_configs; k++) {
+					int c = (k + round) % n_configs;
+					if (toggle)
+						sweep_apply(sw, c);
+					rounds[c * COMPARE_ROUNDS + round] =
+						run_counted(fn, &cfg);
+				}
+			}
+			for (int c = 0; c < n_configs; c++) {
+				struct stat_result r =
+					stats_merge(&rounds[c * COMPARE_ROUNDS],
+						    COMPARE_ROUNDS);
+				if (toggle)
+					sweep_label(sw, c, label, sizeof(label));
+				else
+					snprintf(label, sizeof(label), "current");
+				sweep_print_row(bg, ncpus, cfg.n_threads, label,
+						&r);
+			}
+			fflush(stdout);
+		}
+	}
+
+	if (toggle)
+		sweep_restore(sw, orig_poc);
+	free(rounds);
+}
+
 /* ------------------------------------------------------------------ */
 /*  Main                                                               */
 /* ------------------------------------------------------------------ */
@@ -559,9 +1847,20 @@ static void usage(const char *prog)
 		"  -t, --threads <N>                       Worker threads (default: nproc)\n"
 		"  -b, --background <N>                    Background threads (default: nproc/2)\n"
 		"  -w, --warmup <N>                        Warmup iterations (default: %d)\n"
+		"  -k, --knob <NAME>                       Sysctl toggled for ON/OFF (default: %s)\n"
+		"  -s, --scenario <LIST>                   burst, pipe, futex, fanout or all (default: burst)\n"
+		"  -g, --groups <N>                        Sender groups of the fanout scenario (default: %d)\n"
 		"      --no-compare                        Skip POC ON/OFF comparison\n"
+		"      --precise                           Pinned SCHED_FIFO dispatcher, TSC pacing, locked buffers (burst)\n"
+		"      --gap <NS>                          Gap between burst rounds (default: %d, --precise: %d)\n"
+		"      --sweep                             Latency vs. background load, every knob combination\n"
+		"      --sweep-steps <N>                   Load steps from 0 to nproc-1 (default: %d)\n"
+		"      --sweep-threads <LIST>              Worker counts to sweep (default: -t)\n"
+		"      --sweep-knobs <LIST>                Sysctls combined with --knob, or all (default: %s)\n"
 		"  -h, --help                              Show this help\n",
-		prog, DEFAULT_ITERATIONS, DEFAULT_WARMUP);
+		prog, DEFAULT_ITERATIONS, DEFAULT_WARMUP, DEFAULT_KNOB,
+		DEFAULT_GROUPS, DEFAULT_GAP_NS, PRECISE_GAP_NS,
+		DEFAULT_SWEEP_STEPS, DEFAULT_SWEEP_KNOBS);
 }
 
 int main(int argc, char *argv[])
@@ -571,27 +1870,101 @@ int main(int argc, char *argv[])
 	int n_threads = ncpus;
 	int n_background = ncpus / 2;
 	int warmup = DEFAULT_WARMUP;
+	int n_groups = DEFAULT_GROUPS;
+	bool selected[NR_SCENARIOS] = { [0] = true };
 	bool compare = true;
+	char default_knobs[] = DEFAULT_SWEEP_KNOBS;
+	char *sweep_knobs = default_knobs;
+	struct sweep sw = { .steps = DEFAULT_SWEEP_STEPS };
+	bool precise = false;
+	long gap_ns = -1;
 
 	static struct option long_opts[] = {
 		{"iterations", required_argument, NULL, 'i'},
 		{"threads",    required_argument, NULL, 't'},
 		{"background", required_argument, NULL, 'b'},
 		{"warmup",     required_argument, NULL, 'w'},
+		{"knob",       required_argument, NULL, 'k'},
+		{"scenario",   required_argument, NULL, 's'},
+		{"groups",     required_argument, NULL, 'g'},
 		{"no-compare", no_argument,       NULL, 'C'},
+		{"precise",       no_argument,       NULL, 'R'},
+		{"gap",           required_argument, NULL, 'G'},
+		{"sweep",         no_argument,       NULL, 'S'},
+		{"sweep-steps",   required_argument, NULL, 'P'},
+		{"sweep-threads", required_argument, NULL, 'T'},
+		{"sweep-knobs",   required_argument, NULL, 'K'},
 		{"help",       no_argument,       NULL, 'h'},
 		{NULL, 0, NULL, 0}
 	};
 
 	int opt;
-	while ((opt = getopt_long(argc, argv, "i:t:b:w:h", long_opts,
+	while ((opt = getopt_long(argc, argv, "i:t:b:w:k:s:g:h", long_opts,
 				  NULL)) != -1) {
 		switch (opt) {
 		case 'i': iterations = atoi(optarg); break;
 		case 't': n_threads = atoi(optarg); break;
 		case 'b': n_background = atoi(optarg); break;
 		case 'w': warmup = atoi(optarg); break;
+		case 'k':
+			if (!*optarg || strchr(optarg, '/')) {
+				fprintf(stderr, "invalid knob: %s\n", optarg);
+				return 1;
+			}
+			knob_name = optarg;
+			snprintf(knob_path, sizeof(knob_path), "%s%s",
+				 SYSCTL_DIR, optarg);
+			break;
+		case 's':
+			memset(selected, 0, sizeof(selected));
+			for (char *tok = strtok(optarg, ","); tok;
+			     tok = strtok(NULL, ",")) {
+				bool found = false;
+				for (int i = 0; i < NR_SCENARIOS; i++) {
+					if (!strcmp(tok, "all") ||
+					    !strcmp(tok, scenarios[i].name)) {
+						selected[i] = true;
+						found = true;
+					}
+				}
+				if (!found) {
+					fprintf(stderr, "unknown scenario: %s\n", tok);
+					return 1;
+				}
+			}
+			break;
+		case 'g': n_groups = atoi(optarg); break;
 		case 'C': compare = false; break;
+		case 'R': precise = true; break;
+		case 'G':
+			gap_ns = atol(optarg);
+			if (gap_ns < 0 || gap_ns >= (long)NS_PER_SEC) {
+				fprintf(stderr, "invalid gap: %s\n", optarg);
+				return 1;
+			}
+			break;
+		case 'S': sw.enabled = true; break;
+		case 'P':
+			sw.steps = atoi(optarg);
+			if (sw.steps < 1) {
+				fprintf(stderr, "invalid sweep steps: %s\n", optarg);
+				return 1;
+			}
+			break;
+		case 'T':
+			sw.n_threads = 0;
+			for (char *tok = strtok(optarg, ","); tok;
+			     tok = strtok(NULL, ",")) {
+				if (sw.n_threads == SWEEP_MAX_THREADS ||
+				    atoi(tok) < 1) {
+					fprintf(stderr, "invalid sweep threads: %s\n",
+						tok);
+					return 1;
+				}
+				sw.threads[sw.n_threads++] = atoi(tok);
+			}
+			break;
+		case 'K': sweep_knobs = optarg; break;
 		case 'h': usage(argv[0]); return 0;
 		default:  usage(argv[0]); return 1;
 		}
@@ -604,6 +1977,7 @@ int main(int argc, char *argv[])
 	read_cpu_model();
 	struct hw_features hw = detect_hw_features();
 	int phys_cores = count_physical_cores();
+	read_cpu_topology();
 
 	printf("=== POC Selector Microbenchmark ===\n");
 	printf("CPU: %s\n", cpu_model_name);
@@ -611,21 +1985,64 @@ int main(int argc, char *argv[])
 	       hw.popcnt, hw.ctz, hw.ptselect);
 	printf("     %d CPUs online, %d cores\n", ncpus, phys_cores);
 
+	if (precise && ncpus < 2) {
+		/* A spinning FIFO dispatcher would starve its own workers */
+		printf("--precise needs at least 2 CPUs, ignored\n");
+		precise = false;
+	}
+	if (precise) {
+		pace_calibrate();
+		printf("     precise dispatch: CPU 0 SCHED_FIFO, %.3f ticks/ns\n",
+		       pace_ticks_per_ns);
+	}
+	if (gap_ns < 0)
+		gap_ns = precise ? PRECISE_GAP_NS : DEFAULT_GAP_NS;
+
 	int poc_val = poc_selector_read();
 	if (poc_val >= 0)
-		printf("sched_poc_selector: %d\n", poc_val);
+		printf("%s: %d\n", knob_name, poc_val);
 	else
-		printf("sched_poc_selector: not available (kernel may lack POC support)\n");
+		printf("%s: not available (kernel may lack POC support)\n",
+		       knob_name);
 
 	struct run_config cfg = {
 		.iterations   = iterations,
 		.warmup       = warmup,
 		.n_threads    = n_threads,
 		.n_background = n_background,
+		.n_groups     = n_groups,
 		.compare      = compare,
+		.precise      = precise,
+		.gap_ns       = (uint64_t)gap_ns,
 	};
 
-	run_scenario("Burst with Background Load", &cfg, run_burst);
+	if (sw.enabled) {
+		for (char *tok = strtok(sweep_knobs, ","); tok;
+		     tok = strtok(NULL, ",")) {
+			if (!strcmp(tok, "all")) {
+				sw.n_knobs = 0;
+				for (int i = 0; i < NR_SWEEP_KNOBS; i++)
+					sw.knobs[sw.n_knobs++] = sweep_knobs_all[i];
+				break;
+			}
+			if (sw.n_knobs == NR_SWEEP_KNOBS || strchr(tok, '/')) {
+				fprintf(stderr, "invalid sweep knob: %s\n", tok);
+				return 1;
+			}
+			sw.knobs[sw.n_knobs++] = tok;
+		}
+		if (poc_val >= 0)
+			sweep_probe_knobs(&sw);
+	}
+
+	for (int i = 0; i < NR_SCENARIOS; i++) {
+		if (!selected[i])
+			continue;
+		if (sw.enabled)
+			run_sweep(scenarios[i].title, &cfg, scenarios[i].fn, &sw);
+		else
+			run_scenario(scenarios[i].title, &cfg, scenarios[i].fn);
+	}
 
 	printf("\nDone.\n");
 	return 0;
@@ -1,8 +1,10 @@
-use crate::system::BenchParams;
+use crate::perf::{self, PerfThread};
+use crate::stats::{PerfCounts, Placement};
+use crate::system::{cpu_topology, BenchParams, Scenario};
 use std::sync::atomic::{AtomicBool, AtomicI32, AtomicU32, Ordering};
 use std::sync::mpsc::{self, Receiver};
 use std::sync::Arc;
-use std::thread;
+use std::thread::{self, JoinHandle};
 
 // ---------------------------------------------------------------------------
 // Shadow thread context
@@ -45,29 +47,131 @@ fn shadow_thread(ctx: &ShadowCtx) {
     }
 }
 
+// ---------------------------------------------------------------------------
+// Wakeup log: latency and landing CPU of every measured wakeup
+// ---------------------------------------------------------------------------
+
+// AtomicU64 wrapper (stable since 1.34)
+use std::sync::atomic::AtomicU64;
+
+/// One per woken thread. Round `i` of every log is the same dispatch round,
+/// so `placement_compute()` can spot two wakees of one round on one CPU.
+struct WakeLog {
+    warmup: usize,
+    latencies: Vec<AtomicU64>,
+    wake_cpu: Vec<AtomicI32>, // CPU of each measured wakeup
+    prev_cpu: Vec<AtomicI32>, // and of the wakeup before it
+}
+
+impl WakeLog {
+    fn new(warmup: usize, iterations: usize) -> Self {
+        Self {
+            warmup,
+            latencies: (0..iterations).map(|_| AtomicU64::new(0)).collect(),
+            wake_cpu: (0..iterations).map(|_| AtomicI32::new(-1)).collect(),
+            prev_cpu: (0..iterations).map(|_| AtomicI32::new(-1)).collect(),
+        }
+    }
+
+    /// Right after the wakee returns from its blocking call for round `i`
+    fn record(&self, i: usize, t0: u64, last_cpu: &mut i32) {
+        let t1 = now_ns();
+        let cpu = sched_getcpu() as i32;
+        if i >= self.warmup {
+            self.latencies[i - self.warmup].store(t1.wrapping_sub(t0), Ordering::Relaxed);
+            self.wake_cpu[i - self.warmup].store(cpu, Ordering::Relaxed);
+            self.prev_cpu[i - self.warmup].store(*last_cpu, Ordering::Relaxed);
+        }
+        *last_cpu = cpu;
+    }
+}
+
+/// Latencies of all logs, plus where the wakees landed
+fn collect(logs: &[&WakeLog], iterations: usize, busy: &[usize]) -> BurstResult {
+    let mut latencies = Vec::with_capacity(iterations * logs.len());
+    for log in logs {
+        latencies.extend(log.latencies.iter().map(|v| v.load(Ordering::Relaxed)));
+    }
+    let wakeups = logs
+        .iter()
+        .map(|log| (log.warmup + log.latencies.len()) as u64)
+        .sum();
+    BurstResult {
+        latencies,
+        placement: placement_compute(logs, iterations, busy),
+        perf: PerfCounts {
+            wakeups,
+            ..Default::default()
+        },
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Background load
+// ---------------------------------------------------------------------------
+
+struct BgLoad {
+    stop: Arc<AtomicBool>,
+    handles: Vec<JoinHandle<()>>,
+    cpus: Vec<usize>,
+}
+
+impl BgLoad {
+    /// Burn threads pinned to CPUs 1..=n (CPU 0 is the dispatcher's)
+    fn start(n: usize) -> Self {
+        let stop = Arc::new(AtomicBool::new(false));
+        let cpus: Vec<usize> = (1..=n).collect();
+        let handles = cpus
+            .iter()
+            .map(|&cpu| {
+                let stop = Arc::clone(&stop);
+                thread::spawn(move || {
+                    pin_self(cpu);
+                    while !stop.load(Ordering::Relaxed) {
+                        for _ in 0..10000u32 {
+                            core::hint::spin_loop();
+                        }
+                    }
+                })
+            })
+            .collect();
+        Self {
+            stop,
+            handles,
+            cpus,
+        }
+    }
+
+    fn finish(self) -> Vec<usize> {
+        self.stop.store(true, Ordering::Relaxed);
+        for h in self.handles {
+            h.join().ok();
+        }
+        self.cpus
+    }
+}
+
 // ---------------------------------------------------------------------------
 // Worker thread context
 // ---------------------------------------------------------------------------
 
 struct WorkerCtx {
     efd: i32,
-    warmup: usize,
     total: usize,
     shadows: Vec<Arc<ShadowCtx>>,
     sync_done: Arc<AtomicU32>,
     ts_wake: Vec<AtomicU64>,
-    latencies: Vec<AtomicU64>,
+    log: WakeLog,
 }
 
-// AtomicU64 wrapper (stable since 1.34)
-use std::sync::atomic::AtomicU64;
-
 fn worker_thread(ctx: &WorkerCtx) {
+    let perf = PerfThread::begin();
     let n_shadows = ctx.shadows.len();
     let mut sidx: usize = 0;
 
     // Initial shadow setup
     let cpu = sched_getcpu();
+    let mut last_cpu = cpu as i32;
     ctx.shadows[0].ack.store(0, Ordering::Release);
     ctx.shadows[0]
         .target_cpu
@@ -78,16 +182,15 @@ fn worker_thread(ctx: &WorkerCtx) {
     let mut buf = [0u8; 8];
     for i in 0..ctx.total {
         // Block on eventfd
+        perf.enable();
         let n = unsafe { libc::read(ctx.efd, buf.as_mut_ptr() as *mut libc::c_void, 8) };
+        perf.disable();
         if n != 8 {
             break;
         }
 
-        let t1 = now_ns();
         let t0 = ctx.ts_wake[i].load(Ordering::Acquire);
-        if i >= ctx.warmup {
-            ctx.latencies[i - ctx.warmup].store(t1.wrapping_sub(t0), Ordering::Relaxed);
-        }
+        ctx.log.record(i, t0, &mut last_cpu);
 
         // Brief compute
         let mut x: u32 = 0;
@@ -124,14 +227,23 @@ fn bounded_spin_wait(ack: &AtomicI32) {
 // Async benchmark handle
 // ---------------------------------------------------------------------------
 
+/// One run: wake-to-run latencies (ns), where the wakees landed, and the
+/// perf_event counters of the waking and woken threads
+#[derive(Default)]
+pub struct BurstResult {
+    pub latencies: Vec<u64>,
+    pub placement: Placement,
+    pub perf: PerfCounts,
+}
+
 pub struct BenchHandle {
     pub progress: Arc<AtomicU32>,
     pub total: u32,
-    rx: Receiver<Vec<u64>>,
+    rx: Receiver<BurstResult>,
 }
 
 impl BenchHandle {
-    pub fn try_recv(&self) -> Option<Vec<u64>> {
+    pub fn try_recv(&self) -> Option<BurstResult> {
         self.rx.try_recv().ok()
     }
 }
@@ -140,7 +252,8 @@ impl BenchHandle {
 // Public API
 // ---------------------------------------------------------------------------
 
-pub fn bench_burst_async(params: &BenchParams, iterations: usize, warmup: usize) -> BenchHandle {
+/// Run `params.scenario` on a background thread
+pub fn bench_async(params: &BenchParams, iterations: usize, warmup: usize) -> BenchHandle {
     let progress = Arc::new(AtomicU32::new(0));
     let (tx, rx) = mpsc::channel();
     let total_iters = (warmup + iterations) as u32;
@@ -149,7 +262,7 @@ pub fn bench_burst_async(params: &BenchParams, iterations: usize, warmup: usize)
     let progress_clone = progress.clone();
 
     thread::spawn(move || {
-        let result = bench_burst_inner(&params, iterations, warmup, &progress_clone);
+        let result = bench_inner(&params, iterations, warmup, &progress_clone);
         let _ = tx.send(result);
     });
 
@@ -160,9 +273,26 @@ pub fn bench_burst_async(params: &BenchParams, iterations: usize, warmup: usize)
     }
 }
 
-pub fn bench_burst_sync(params: &BenchParams, iterations: usize, warmup: usize) -> Vec<u64> {
+pub fn bench_sync(params: &BenchParams, iterations: usize, warmup: usize) -> BurstResult {
     let progress = Arc::new(AtomicU32::new(0));
-    bench_burst_inner(params, iterations, warmup, &progress)
+    bench_inner(params, iterations, warmup, &progress)
+}
+
+fn bench_inner(
+    params: &BenchParams,
+    iterations: usize,
+    warmup: usize,
+    progress: &AtomicU32,
+) -> BurstResult {
+    perf::reset();
+    let mut result = match params.scenario {
+        Scenario::Burst => bench_burst_inner(params, iterations, warmup, progress),
+        Scenario::Pipe => bench_pipe_inner(params, iterations, warmup, progress),
+        Scenario::Futex => bench_futex_inner(params, iterations, warmup, progress),
+        Scenario::Fanout => bench_fanout_inner(params, iterations, warmup, progress),
+    };
+    result.perf = perf::snapshot(result.perf.wakeups);
+    result
 }
 
 fn bench_burst_inner(
@@ -170,7 +300,7 @@ fn bench_burst_inner(
     iterations: usize,
     warmup: usize,
     progress: &AtomicU32,
-) -> Vec<u64> {
+) -> BurstResult {
     let ncpus = unsafe { libc::sysconf(libc::_SC_NPROCESSORS_ONLN) as usize };
     let total = warmup + iterations;
     let n_workers = params.n_workers;
@@ -210,16 +340,14 @@ fn bench_burst_inner(
             .collect();
 
         let ts_wake: Vec<AtomicU64> = (0..total).map(|_| AtomicU64::new(0)).collect();
-        let latencies: Vec<AtomicU64> = (0..iterations).map(|_| AtomicU64::new(0)).collect();
 
         worker_ctxs.push(Arc::new(WorkerCtx {
             efd,
-            warmup,
             total,
             shadows,
             sync_done: Arc::clone(&sync_done),
             ts_wake,
-            latencies,
+            log: WakeLog::new(warmup, iterations),
         }));
     }
 
@@ -232,20 +360,7 @@ fn bench_burst_inner(
         .collect();
 
     // --- 3. Background burn threads ---
-    let bg_stop = Arc::new(AtomicBool::new(false));
-    let bg_handles: Vec<_> = (0..n_background)
-        .map(|i| {
-            let stop = Arc::clone(&bg_stop);
-            thread::spawn(move || {
-                pin_self(i + 1); // skip CPU 0 (dispatcher)
-                while !stop.load(Ordering::Relaxed) {
-                    for _ in 0..10000u32 {
-                        core::hint::spin_loop();
-                    }
-                }
-            })
-        })
-        .collect();
+    let bg = BgLoad::start(n_background);
 
     // --- 4. Pin dispatcher to CPU 0 with SCHED_FIFO ---
     pin_self(0);
@@ -261,6 +376,7 @@ fn bench_burst_inner(
 
     // --- 6. Dispatch ---
     let wval: u64 = 1;
+    let dispatch_perf = PerfThread::begin();
     for i in 0..total {
         if i > 0 {
             while sync_done.load(Ordering::Acquire) < n_workers as u32 {
@@ -272,6 +388,7 @@ fn bench_burst_inner(
             busy_wait_ns(10_000);
         }
 
+        dispatch_perf.enable();
         for w in 0..n_workers {
             let t0 = now_ns();
             worker_ctxs[w].ts_wake[i].store(t0, Ordering::Release);
@@ -283,9 +400,11 @@ fn bench_burst_inner(
                 );
             }
         }
+        dispatch_perf.disable();
 
         progress.store(i as u32 + 1, Ordering::Relaxed);
     }
+    drop(dispatch_perf);
 
     // Join workers
     for h in worker_handles {
@@ -293,10 +412,7 @@ fn bench_burst_inner(
     }
 
     // Stop background
-    bg_stop.store(true, Ordering::Relaxed);
-    for h in bg_handles {
-        h.join().ok();
-    }
+    let bg_cpus = bg.finish();
 
     // Stop shadows
     for ctx in &shadow_ctxs {
@@ -306,13 +422,11 @@ fn bench_burst_inner(
         h.join().ok();
     }
 
-    // Collect latencies
-    let mut all = Vec::with_capacity(iterations * n_workers);
-    for w in 0..n_workers {
-        for i in 0..iterations {
-            all.push(worker_ctxs[w].latencies[i].load(Ordering::Relaxed));
-        }
-    }
+    // Collect latencies; the dispatcher (CPU 0) and background threads
+    // keep their CPUs busy
+    let busy: Vec<usize> = std::iter::once(0).chain(bg_cpus).collect();
+    let logs: Vec<&WakeLog> = worker_ctxs.iter().map(|w| &w.log).collect();
+    let result = collect(&logs, iterations, &busy);
 
     // Close eventfds
     for &efd in &worker_efds {
@@ -329,7 +443,304 @@ fn bench_burst_inner(
         set_affinity_mask(&mask);
     }
 
-    all
+    result
+}
+
+// ---------------------------------------------------------------------------
+// Pipe ping-pong
+// ---------------------------------------------------------------------------
+
+/// Pairs of threads bouncing a timestamp over two pipes: every wakeup is a
+/// 1:1 synchronous handoff, the case wake_affine() and the POC target's
+/// "prev CPU" fast path are built for. Two threads per pair.
+fn bench_pipe_inner(
+    params: &BenchParams,
+    iterations: usize,
+    warmup: usize,
+    progress: &AtomicU32,
+) -> BurstResult {
+    let ncpus = unsafe { libc::sysconf(libc::_SC_NPROCESSORS_ONLN) as usize };
+    let total = warmup + iterations;
+    let n_pairs = (params.n_workers / 2).max(1);
+    let bg = BgLoad::start(params.n_background.min(ncpus - 1));
+
+    // (read, write) ends of both sides of every pair
+    let mut fds: Vec<(i32, i32)> = Vec::with_capacity(2 * n_pairs);
+    for _ in 0..n_pairs {
+        let mut ab = [0i32; 2];
+        let mut ba = [0i32; 2];
+        unsafe {
+            assert!(libc::pipe(ab.as_mut_ptr()) == 0, "pipe failed");
+            assert!(libc::pipe(ba.as_mut_ptr()) == 0, "pipe failed");
+        }
+        fds.push((ba[0], ab[1])); // initiator
+        fds.push((ab[0], ba[1])); // responder
+    }
+    let logs: Vec<WakeLog> = (0..2 * n_pairs)
+        .map(|_| WakeLog::new(warmup, iterations))
+        .collect();
+
+    thread::scope(|s| {
+        // Responders first, so that every first request finds a reader
+        for side in (0..2 * n_pairs).rev() {
+            let (rfd, wfd) = fds[side];
+            let log = &logs[side];
+            let initiator = side % 2 == 0;
+            s.spawn(move || {
+                let perf = PerfThread::begin();
+                let mut last_cpu = sched_getcpu() as i32;
+                for i in 0..total {
+                    // The window spans the request and the response
+                    perf.enable();
+                    if initiator && !write_ts(wfd, now_ns()) {
+                        break;
+                    }
+                    let Some(t0) = read_ts(rfd) else { break };
+                    log.record(i, t0, &mut last_cpu);
+                    if !initiator && !write_ts(wfd, now_ns()) {
+                        break;
+                    }
+                    perf.disable();
+                    if initiator {
+                        // Think time: the responder goes back to sleep
+                        thread::sleep(std::time::Duration::from_micros(1));
+                        if side == 0 {
+                            progress.store(i as u32 + 1, Ordering::Relaxed);
+                        }
+                    }
+                }
+            });
+        }
+    });
+
+    let busy = bg.finish();
+    let refs: Vec<&WakeLog> = logs.iter().collect();
+    let result = collect(&refs, iterations, &busy);
+
+    for (rfd, wfd) in fds {
+        unsafe {
+            libc::close(rfd);
+            libc::close(wfd);
+        }
+    }
+    result
+}
+
+// ---------------------------------------------------------------------------
+// Futex wake-many
+// ---------------------------------------------------------------------------
+
+/// All workers sleep on one futex and a single FUTEX_WAKE releases them
+/// together: one waker, N wakees, all selected back to back from one CPU.
+fn bench_futex_inner(
+    params: &BenchParams,
+    iterations: usize,
+    warmup: usize,
+    progress: &AtomicU32,
+) -> BurstResult {
+    let ncpus = unsafe { libc::sysconf(libc::_SC_NPROCESSORS_ONLN) as usize };
+    let total = warmup + iterations;
+    let n_waiters = params.n_workers.max(1);
+    let bg = BgLoad::start(params.n_background.min(ncpus - 1));
+
+    let seq = AtomicU32::new(0);
+    let ts_wake = AtomicU64::new(0);
+    let done = AtomicU32::new(0); // waiters finished with the current round
+    let logs: Vec<WakeLog> = (0..n_waiters)
+        .map(|_| WakeLog::new(warmup, iterations))
+        .collect();
+
+    thread::scope(|s| {
+        for log in &logs {
+            let (seq, ts_wake, done) = (&seq, &ts_wake, &done);
+            s.spawn(move || {
+                let perf = PerfThread::begin();
+                let mut last_cpu = sched_getcpu() as i32;
+                for i in 0..total {
+                    done.fetch_add(1, Ordering::AcqRel);
+                    perf.enable();
+                    while seq.load(Ordering::Acquire) == i as u32 {
+                        futex_op(seq, libc::FUTEX_WAIT, i as u32);
+                    }
+                    perf.disable();
+                    log.record(i, ts_wake.load(Ordering::Acquire), &mut last_cpu);
+                }
+            });
+        }
+
+        let perf = PerfThread::begin();
+        for i in 0..total {
+            // Every waiter back in (or on its way into) FUTEX_WAIT
+            while done.load(Ordering::Acquire) < n_waiters as u32 {
+                thread::yield_now();
+            }
+            done.store(0, Ordering::Release);
+            thread::sleep(std::time::Duration::from_micros(10));
+
+            perf.enable();
+            ts_wake.store(now_ns(), Ordering::Release);
+            seq.store(i as u32 + 1, Ordering::Release);
+            futex_op(&seq, libc::FUTEX_WAKE, i32::MAX as u32);
+            perf.disable();
+            progress.store(i as u32 + 1, Ordering::Relaxed);
+        }
+    });
+
+    let busy = bg.finish();
+    let refs: Vec<&WakeLog> = logs.iter().collect();
+    collect(&refs, iterations, &busy)
+}
+
+// ---------------------------------------------------------------------------
+// Socket fan-out (hackbench-style)
+// ---------------------------------------------------------------------------
+
+/// Groups of one sender and N receivers, each receiver on its own AF_UNIX
+/// socketpair. Every round the sender writes one timestamped message to
+/// each of its receivers back to back, so the wakeups of a group -- and of
+/// all groups -- race for the same idle CPUs.
+fn bench_fanout_inner(
+    params: &BenchParams,
+    iterations: usize,
+    warmup: usize,
+    progress: &AtomicU32,
+) -> BurstResult {
+    let ncpus = unsafe { libc::sysconf(libc::_SC_NPROCESSORS_ONLN) as usize };
+    let total = warmup + iterations;
+    let n_receivers = params.n_workers.max(1);
+    let n_groups = params.n_groups.clamp(1, n_receivers);
+    let bg = BgLoad::start(params.n_background.min(ncpus - 1));
+
+    // Receivers dealt round-robin over the groups: (sender end, receiver end)
+    let mut socks: Vec<(i32, i32)> = Vec::with_capacity(n_receivers);
+    for _ in 0..n_receivers {
+        let mut sv = [0i32; 2];
+        let rc = unsafe {
+            libc::socketpair(libc::AF_UNIX, libc::SOCK_STREAM, 0, sv.as_mut_ptr())
+        };
+        assert!(rc == 0, "socketpair failed");
+        socks.push((sv[0], sv[1]));
+    }
+    let done: Vec<AtomicU32> = (0..n_groups).map(|_| AtomicU32::new(0)).collect();
+    let logs: Vec<WakeLog> = (0..n_receivers)
+        .map(|_| WakeLog::new(warmup, iterations))
+        .collect();
+
+    thread::scope(|s| {
+        for (r, log) in logs.iter().enumerate() {
+            let (sock, done) = (socks[r].1, &done[r % n_groups]);
+            s.spawn(move || {
+                let perf = PerfThread::begin();
+                let mut last_cpu = sched_getcpu() as i32;
+                for i in 0..total {
+                    done.fetch_add(1, Ordering::AcqRel);
+                    perf.enable();
+                    let t0 = read_ts(sock);
+                    perf.disable();
+                    let Some(t0) = t0 else { break };
+                    log.record(i, t0, &mut last_cpu);
+                }
+            });
+        }
+
+        for g in 0..n_groups {
+            let senders: Vec<i32> = socks
+                .iter()
+                .skip(g)
+                .step_by(n_groups)
+                .map(|&(tx, _)| tx)
+                .collect();
+            let done = &done[g];
+            s.spawn(move || {
+                let perf = PerfThread::begin();
+                for i in 0..total {
+                    while done.load(Ordering::Acquire) < senders.len() as u32 {
+                        thread::yield_now();
+                    }
+                    done.store(0, Ordering::Release);
+                    thread::sleep(std::time::Duration::from_micros(10));
+
+                    perf.enable();
+                    for &tx in &senders {
+                        if !write_ts(tx, now_ns()) {
+                            return;
+                        }
+                    }
+                    perf.disable();
+                    if g == 0 {
+                        progress.store(i as u32 + 1, Ordering::Relaxed);
+                    }
+                }
+            });
+        }
+    });
+
+    let busy = bg.finish();
+    let refs: Vec<&WakeLog> = logs.iter().collect();
+    let result = collect(&refs, iterations, &busy);
+
+    for (tx, rx) in socks {
+        unsafe {
+            libc::close(tx);
+            libc::close(rx);
+        }
+    }
+    result
+}
+
+fn placement_compute(logs: &[&WakeLog], iterations: usize, busy: &[usize]) -> Placement {
+    let topo = cpu_topology();
+    let n = topo.nr_cpus();
+    let mut is_busy = vec![false; n];
+    let mut smt_busy = vec![false; n];
+    for &b in busy.iter().filter(|&&b| b < n) {
+        is_busy[b] = true;
+        for c in 0..n {
+            if c != b && topo.core[c] == topo.core[b] {
+                smt_busy[c] = true;
+            }
+        }
+    }
+
+    let mut p = Placement::default();
+    let mut round_hits = vec![0u32; n];
+    let cpu_at = |v: &[AtomicI32], i: usize| -> Option<usize> {
+        let c = v[i].load(Ordering::Relaxed);
+        (c >= 0 && (c as usize) < n).then_some(c as usize)
+    };
+    for i in 0..iterations {
+        for w in logs {
+            if let Some(c) = cpu_at(&w.wake_cpu, i) {
+                round_hits[c] += 1;
+            }
+        }
+        for w in logs {
+            let (Some(cpu), Some(prev)) = (cpu_at(&w.wake_cpu, i), cpu_at(&w.prev_cpu, i)) else {
+                continue;
+            };
+            p.total += 1;
+            if cpu == prev {
+                p.same_cpu += 1;
+            } else if is_busy[cpu] {
+                p.busy_cpu += 1;
+            } else if smt_busy[cpu] {
+                p.smt_busy += 1;
+            } else if topo.cluster[cpu] == topo.cluster[prev] {
+                p.same_cluster += 1;
+            } else {
+                p.other_cluster += 1;
+            }
+            if round_hits[cpu] > 1 {
+                p.collided += 1;
+            }
+        }
+        for w in logs {
+            if let Some(c) = cpu_at(&w.wake_cpu, i) {
+                round_hits[c] = 0;
+            }
+        }
+    }
+    p
 }
 
 // ---------------------------------------------------------------------------
@@ -354,6 +765,32 @@ fn busy_wait_ns(ns: u64) {
     }
 }
 
+/// One timestamp over a pipe or socket; false on EOF or error
+fn write_ts(fd: i32, t: u64) -> bool {
+    let n = unsafe { libc::write(fd, &t as *const u64 as *const libc::c_void, 8) };
+    n == 8
+}
+
+fn read_ts(fd: i32) -> Option<u64> {
+    let mut t: u64 = 0;
+    let n = unsafe { libc::read(fd, &mut t as *mut u64 as *mut libc::c_void, 8) };
+    (n == 8).then_some(t)
+}
+
+fn futex_op(uaddr: &AtomicU32, op: i32, val: u32) -> i64 {
+    unsafe {
+        libc::syscall(
+            libc::SYS_futex,
+            uaddr.as_ptr(),
+            op | libc::FUTEX_PRIVATE_FLAG,
+            val,
+            std::ptr::null::<libc::timespec>(),
+            std::ptr::null::<u32>(),
+            0u32,
+        ) as i64
+    }
+}
+
 fn sched_getcpu() -> usize {
     unsafe { libc::sched_getcpu() as usize }
 }
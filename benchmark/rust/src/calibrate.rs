@@ -1,6 +1,7 @@
 use crate::bench;
 use crate::stats::StatResult;
 use crate::system::BenchParams;
+use serde::{Deserialize, Serialize};
 
 const PROBE_MIN_SECS: f64 = 1.0;
 const PROBE_START_N: usize = 50;
@@ -9,6 +10,7 @@ const MAX_N: usize = 500_000;
 const TARGET_PHASE_SECS: f64 = 5.0;
 const WARMUP_RATIO: f64 = 0.2; // 1/5 of main phase
 
+#[derive(Serialize, Deserialize)]
 pub struct CalibrationResult {
     pub iterations: usize,
     pub warmup: usize,
@@ -26,7 +28,7 @@ pub fn calibrate(params: &BenchParams) -> CalibrationResult {
     loop {
         let warmup = (probe_n / 5).max(10);
         let t0 = std::time::Instant::now();
-        samples = bench::bench_burst_sync(params, probe_n, warmup);
+        samples = bench::bench_sync(params, probe_n, warmup).latencies;
         elapsed_s = t0.elapsed().as_secs_f64();
 
         if elapsed_s >= PROBE_MIN_SECS || probe_n >= MAX_N {
@@ -1,10 +1,13 @@
 mod bench;
 mod calibrate;
+mod perf;
+mod report;
 mod stats;
 mod system;
 mod ui;
 
 use std::io;
+use std::path::PathBuf;
 use std::sync::atomic::{AtomicBool, Ordering};
 use std::time::Duration;
 
@@ -17,8 +20,8 @@ use crossterm::ExecutableCommand;
 use ratatui::backend::CrosstermBackend;
 use ratatui::Terminal;
 
-use crate::stats::{Histogram, StatResult};
-use crate::system::{BenchParams, SystemInfo};
+use crate::stats::{Histogram, PerfCounts, Placement, StatResult};
+use crate::system::{BenchParams, Scenario, SystemInfo};
 use crate::ui::{App, Phase};
 
 const DEFAULT_ROUNDS: usize = 4;
@@ -82,6 +85,40 @@ struct Cli {
     /// Skip POC ON/OFF comparison
     #[arg(long)]
     no_compare: bool,
+
+    /// Wakeup pattern to measure
+    #[arg(short, long, value_enum, default_value_t = Scenario::Burst)]
+    scenario: Scenario,
+
+    /// Sender groups for the fanout scenario
+    #[arg(short, long, default_value_t = 2)]
+    groups: usize,
+
+    /// Write the results (system, parameters, statistics, histograms,
+    /// placement, perf counters, raw samples) to this file
+    #[arg(short, long)]
+    output: Option<PathBuf>,
+
+    /// Format of --output
+    #[arg(long, value_enum, default_value_t = report::Format::Json)]
+    format: report::Format,
+
+    /// Compare two JSON result files instead of running; exits 1 on a
+    /// statistically significant regression of the candidate
+    #[arg(long, num_args = 2, value_names = ["BASE", "CANDIDATE"])]
+    compare_files: Option<Vec<PathBuf>>,
+
+    /// Compare the CFS (POC OFF) side instead of POC ON
+    #[arg(long)]
+    compare_off: bool,
+
+    /// Significance level of the comparison
+    #[arg(long, default_value_t = 0.01)]
+    alpha: f64,
+
+    /// Ignore regressions smaller than this many percent
+    #[arg(long, default_value_t = 2.0)]
+    threshold: f64,
 }
 
 // ---------------------------------------------------------------------------
@@ -90,13 +127,24 @@ struct Cli {
 
 fn main() {
     let cli = Cli::parse();
+    if let Some(files) = &cli.compare_files {
+        let opt = report::GateOptions {
+            side_on: !cli.compare_off,
+            alpha: cli.alpha,
+            threshold_pct: cli.threshold,
+        };
+        std::process::exit(report::compare_files(&files[0], &files[1], &opt));
+    }
+
     let sysinfo = SystemInfo::detect();
-    let params = BenchParams::with_overrides(
+    let mut params = BenchParams::with_overrides(
         sysinfo.ncpus,
         sysinfo.physical_cores,
         Some(cli.threads),
         Some(cli.background),
     );
+    params.scenario = cli.scenario;
+    params.n_groups = cli.groups;
 
     // Lock memory
     unsafe {
@@ -201,14 +249,18 @@ fn main() {
                     total_rounds: 1,
                     poc_on: sysctl_readable && orig_poc > 0,
                 };
-                let handle = bench::bench_burst_async(&params, iterations, warmup);
-                let samples = run_with_progress(&mut terminal, &mut app, &handle);
+                let handle = bench::bench_async(&params, iterations, warmup);
+                let res = run_with_progress(&mut terminal, &mut app, &handle);
+                let samples = res.latencies;
 
                 if !samples.is_empty() {
                     let mut s = samples.clone();
                     let sr = StatResult::compute(&mut s);
                     app.hist_on = Some(Histogram::from_samples(&samples));
                     app.final_on = Some(sr);
+                    app.place_on = Some(res.placement);
+                    app.perf_on = Some(res.perf);
+                    app.samples_on = samples;
                 }
             }
         }
@@ -250,6 +302,15 @@ fn main() {
     terminal.show_cursor().ok();
     if show_summary {
         ui::print_summary(&app);
+        if let Some(path) = &cli.output {
+            let rounds = if compare { cli.rounds } else { 1 };
+            let r = report::Report::from_app(&app, iterations, warmup, rounds);
+            if let Err(e) = r.write(path, cli.format) {
+                eprintln!("failed to write {}: {}", path.display(), e);
+                std::process::exit(1);
+            }
+            println!("Results written to {}", path.display());
+        }
     }
 }
 
@@ -271,7 +332,7 @@ fn run_comparison(
     let discard_w = (warmup / 5).max(100);
 
     system::poc_sysctl_write(1).ok();
-    let h = bench::bench_burst_async(params, discard_n, discard_w);
+    let h = bench::bench_async(params, discard_n, discard_w);
     let _ = run_with_progress(terminal, app, &h);
     if quitting() {
         return;
@@ -280,7 +341,7 @@ fn run_comparison(
     system::poc_sysctl_write(0).ok();
     app.progress = 0.5;
     terminal.draw(|f| ui::draw(f, app)).ok();
-    let h = bench::bench_burst_async(params, discard_n, discard_w);
+    let h = bench::bench_async(params, discard_n, discard_w);
     let _ = run_with_progress(terminal, app, &h);
     if quitting() {
         return;
@@ -289,8 +350,6 @@ fn run_comparison(
     // --- Measured rounds ---
     let mut results_on = Vec::new();
     let mut results_off = Vec::new();
-    let mut all_on = Vec::new();
-    let mut all_off = Vec::new();
 
     'rounds: for round in 0..rounds {
         let on_first = round % 2 == 0;
@@ -314,8 +373,9 @@ fn run_comparison(
             terminal.draw(|f| ui::draw(f, app)).ok();
 
             system::poc_sysctl_write(if poc_on { 1 } else { 0 }).ok();
-            let h = bench::bench_burst_async(params, iterations, warmup);
-            let samples = run_with_progress(terminal, app, &h);
+            let h = bench::bench_async(params, iterations, warmup);
+            let res = run_with_progress(terminal, app, &h);
+            let samples = res.latencies;
 
             if quitting() {
                 break 'rounds;
@@ -324,21 +384,25 @@ fn run_comparison(
             if !samples.is_empty() {
                 let mut s = samples.clone();
                 let sr = StatResult::compute(&mut s);
-                if poc_on {
-                    all_on.extend_from_slice(&samples);
+                let (place, perf) = if poc_on {
+                    app.samples_on.extend_from_slice(&samples);
                     results_on.push(sr);
+                    (&mut app.place_on, &mut app.perf_on)
                 } else {
-                    all_off.extend_from_slice(&samples);
+                    app.samples_off.extend_from_slice(&samples);
                     results_off.push(sr);
-                }
+                    (&mut app.place_off, &mut app.perf_off)
+                };
+                place.get_or_insert_with(Placement::default).add(&res.placement);
+                perf.get_or_insert_with(PerfCounts::default).add(&res.perf);
             }
 
             // Update histograms with cumulative data
-            if !all_on.is_empty() {
-                app.hist_on = Some(Histogram::from_samples(&all_on));
+            if !app.samples_on.is_empty() {
+                app.hist_on = Some(Histogram::from_samples(&app.samples_on));
             }
-            if !all_off.is_empty() {
-                app.hist_off = Some(Histogram::from_samples(&all_off));
+            if !app.samples_off.is_empty() {
+                app.hist_off = Some(Histogram::from_samples(&app.samples_off));
             }
             if !results_on.is_empty() {
                 app.final_on = Some(StatResult::merge(&results_on));
@@ -359,10 +423,10 @@ fn run_with_progress(
     terminal: &mut Terminal<CrosstermBackend<io::Stdout>>,
     app: &mut App,
     handle: &bench::BenchHandle,
-) -> Vec<u64> {
+) -> bench::BurstResult {
     loop {
         if quitting() {
-            return Vec::new();
+            return bench::BurstResult::default();
         }
 
         let p = handle.progress.load(Ordering::Relaxed);
@@ -382,7 +446,7 @@ fn run_with_progress(
             if let Ok(ev) = event::read() {
                 if is_quit_event(&ev) {
                     QUIT.store(true, Ordering::Relaxed);
-                    return Vec::new();
+                    return bench::BurstResult::default();
                 }
             }
         }
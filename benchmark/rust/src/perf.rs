@@ -0,0 +1,168 @@
+//! perf_event counters of the threads that wake or are woken.
+//!
+//! Every such thread -- not the background burners, which would drown
+//! everything in spin cycles, and not the shadows -- opens one counter
+//! group, disabled, and enables it only across its wake syscall (the waker:
+//! `write()`, FUTEX_WAKE) or its wait syscall (the wakee: `read()`,
+//! FUTEX_WAIT). At exit it adds its totals to a process-wide sum that
+//! `bench_inner()` resets and snapshots around one run. Pacing sleeps, the
+//! spin until a round is done and the workers' compute and shadow handoff
+//! stay outside, so kernel cycles are the waker's `select_task_rq()` (and
+//! thus the selector) plus the wakee's side of the switch, and the switches
+//! are the wakees blocking. The enable and disable ioctls add a constant of
+//! their own, equal for both sides. A counter the kernel refuses
+//! (perf_event_paranoid, no PMU in a VM) is reported as n/a.
+
+use crate::stats::{PerfCounts, NR_PERF};
+use std::sync::atomic::{AtomicBool, AtomicU64, Ordering};
+
+const PERF_TYPE_HARDWARE: u32 = 0;
+const PERF_TYPE_SOFTWARE: u32 = 1;
+const PERF_COUNT_HW_CPU_CYCLES: u64 = 0;
+const PERF_COUNT_HW_CACHE_MISSES: u64 = 3;
+const PERF_COUNT_SW_CONTEXT_SWITCHES: u64 = 3;
+const PERF_COUNT_SW_CPU_MIGRATIONS: u64 = 4;
+const FLAG_DISABLED: u64 = 1 << 0;
+const FLAG_EXCLUDE_USER: u64 = 1 << 4;
+const FLAG_EXCLUDE_HV: u64 = 1 << 6;
+const PERF_EVENT_IOC_ENABLE: libc::c_ulong = 0x2400;
+const PERF_EVENT_IOC_DISABLE: libc::c_ulong = 0x2401;
+const PERF_IOC_FLAG_GROUP: libc::c_ulong = 1;
+
+/// `struct perf_event_attr` up to config1 (PERF_ATTR_SIZE_VER0)
+#[repr(C)]
+#[derive(Default)]
+struct PerfEventAttr {
+    type_: u32,
+    size: u32,
+    config: u64,
+    sample_period: u64,
+    sample_type: u64,
+    read_format: u64,
+    flags: u64,
+    wakeup_events: u32,
+    bp_type: u32,
+    config1: u64,
+}
+
+/// (type, config, kernel only), in `PerfCounts` order
+const EVENTS: [(u32, u64, bool); NR_PERF] = [
+    (PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, false),
+    (PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, true),
+    (PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES, false),
+    (PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS, false),
+    (PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, false),
+];
+
+static SUM: [AtomicU64; NR_PERF] = [
+    AtomicU64::new(0),
+    AtomicU64::new(0),
+    AtomicU64::new(0),
+    AtomicU64::new(0),
+    AtomicU64::new(0),
+];
+static FAILED: [AtomicBool; NR_PERF] = [
+    AtomicBool::new(false),
+    AtomicBool::new(false),
+    AtomicBool::new(false),
+    AtomicBool::new(false),
+    AtomicBool::new(false),
+];
+
+/// Counters of the calling thread, counting between `enable()` and
+/// `disable()` and summed up on drop
+pub struct PerfThread {
+    fds: [i32; NR_PERF],
+    leader: i32, // first counter opened, -1 if none
+}
+
+impl PerfThread {
+    pub fn begin() -> Self {
+        let mut fds = [-1; NR_PERF];
+        let mut leader = -1;
+        for (fd, &(type_, config, kernel_only)) in fds.iter_mut().zip(EVENTS.iter()) {
+            let attr = PerfEventAttr {
+                type_,
+                size: std::mem::size_of::<PerfEventAttr>() as u32,
+                config,
+                flags: FLAG_DISABLED
+                    | FLAG_EXCLUDE_HV
+                    | if kernel_only { FLAG_EXCLUDE_USER } else { 0 },
+                ..Default::default()
+            };
+            *fd = unsafe {
+                libc::syscall(
+                    libc::SYS_perf_event_open,
+                    &attr as *const PerfEventAttr,
+                    0 as libc::pid_t,
+                    -1 as libc::c_int,
+                    leader as libc::c_int,
+                    0 as libc::c_ulong,
+                ) as i32
+            };
+            if *fd >= 0 && leader < 0 {
+                leader = *fd;
+            }
+        }
+        for (i, &fd) in fds.iter().enumerate() {
+            if fd < 0 {
+                FAILED[i].store(true, Ordering::Relaxed);
+            }
+        }
+        Self { fds, leader }
+    }
+
+    /// Count across one wake or wait syscall: one ioctl for the whole group
+    #[inline]
+    pub fn enable(&self) {
+        self.ioctl(PERF_EVENT_IOC_ENABLE);
+    }
+
+    #[inline]
+    pub fn disable(&self) {
+        self.ioctl(PERF_EVENT_IOC_DISABLE);
+    }
+
+    fn ioctl(&self, request: libc::c_ulong) {
+        if self.leader >= 0 {
+            unsafe {
+                libc::ioctl(self.leader, request as _, PERF_IOC_FLAG_GROUP);
+            }
+        }
+    }
+}
+
+impl Drop for PerfThread {
+    fn drop(&mut self) {
+        for (i, &fd) in self.fds.iter().enumerate().filter(|(_, &fd)| fd >= 0) {
+            let mut v: u64 = 0;
+            let n = unsafe { libc::read(fd, &mut v as *mut u64 as *mut libc::c_void, 8) };
+            if n == 8 {
+                SUM[i].fetch_add(v, Ordering::Relaxed);
+            }
+            unsafe {
+                libc::close(fd);
+            }
+        }
+    }
+}
+
+pub fn reset() {
+    for i in 0..NR_PERF {
+        SUM[i].store(0, Ordering::Relaxed);
+        FAILED[i].store(false, Ordering::Relaxed);
+    }
+}
+
+/// Totals since `reset()`, once every counting thread has finished
+pub fn snapshot(wakeups: u64) -> PerfCounts {
+    let mut p = PerfCounts {
+        wakeups,
+        ..Default::default()
+    };
+    for i in 0..NR_PERF {
+        p.val[i] = SUM[i].load(Ordering::Relaxed);
+        p.failed[i] = FAILED[i].load(Ordering::Relaxed);
+    }
+    p
+}
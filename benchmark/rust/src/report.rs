@@ -0,0 +1,460 @@
+//! Machine-readable results (`--output`) and the statistical comparison of
+//! two result files (`--compare-files`).
+//!
+//! A JSON report carries everything a run produced: system info, all
+//! parameters, the merged statistics, histogram, placement and perf counters
+//! of both sides, and up to `SAMPLE_CAP` raw latency samples per side for
+//! the significance tests. CSV is one flat row per side, without samples.
+
+use std::fs;
+use std::io::{self, Write};
+use std::path::Path;
+
+use serde::{Deserialize, Serialize};
+
+use crate::calibrate::CalibrationResult;
+use crate::stats::{Histogram, PerfCounts, Placement, StatResult, NUM_BUCKETS};
+use crate::system::{BenchParams, SystemInfo};
+use crate::ui::App;
+
+pub const REPORT_VERSION: u32 = 1;
+
+/// Raw samples kept per side: every k-th one of the side's log, which is
+/// worker after worker within a round and round after round, so every
+/// worker and round keeps its share
+const SAMPLE_CAP: usize = 50_000;
+const BOOTSTRAP_RESAMPLES: usize = 1000;
+
+#[derive(Clone, Copy, PartialEq, Eq, clap::ValueEnum)]
+pub enum Format {
+    Json,
+    Csv,
+}
+
+#[derive(Serialize, Deserialize)]
+pub struct SystemReport {
+    pub cpu_model: String,
+    pub ncpus: usize,
+    pub physical_cores: usize,
+    pub popcnt: String,
+    pub ctz: String,
+    pub ptselect: String,
+    pub kernel: String,
+}
+
+#[derive(Serialize, Deserialize)]
+pub struct SideReport {
+    pub stats: StatResult,
+    pub histogram: Histogram,
+    pub placement: Placement,
+    pub perf: PerfCounts,
+    pub samples: Vec<u64>,
+}
+
+#[derive(Serialize, Deserialize)]
+pub struct Report {
+    pub version: u32,
+    pub system: SystemReport,
+    pub params: BenchParams,
+    pub iterations: usize,
+    pub warmup: usize,
+    pub rounds: usize,
+    pub compared: bool, // false: single run, `on` holds it
+    pub calibration: Option<CalibrationResult>,
+    pub on: Option<SideReport>,
+    pub off: Option<SideReport>,
+}
+
+fn kernel_release() -> String {
+    fs::read_to_string("/proc/sys/kernel/osrelease")
+        .map(|s| s.trim().to_string())
+        .unwrap_or_default()
+}
+
+fn subsample(samples: &[u64]) -> Vec<u64> {
+    let step = samples.len().div_ceil(SAMPLE_CAP).max(1);
+    samples.iter().step_by(step).copied().collect()
+}
+
+impl SystemReport {
+    fn new(sys: &SystemInfo) -> Self {
+        Self {
+            cpu_model: sys.cpu_model.clone(),
+            ncpus: sys.ncpus,
+            physical_cores: sys.physical_cores,
+            popcnt: sys.hw_features.popcnt.to_string(),
+            ctz: sys.hw_features.ctz.to_string(),
+            ptselect: sys.hw_features.ptselect.to_string(),
+            kernel: kernel_release(),
+        }
+    }
+}
+
+impl Report {
+    pub fn from_app(app: &App, iterations: usize, warmup: usize, rounds: usize) -> Self {
+        let side = |stats: &Option<StatResult>,
+                    hist: &Option<Histogram>,
+                    place: &Option<Placement>,
+                    perf: &Option<PerfCounts>,
+                    samples: &[u64]| {
+            stats.as_ref().map(|s| SideReport {
+                stats: s.clone(),
+                histogram: hist.clone().unwrap_or_default(),
+                placement: place.clone().unwrap_or_default(),
+                perf: perf.clone().unwrap_or_default(),
+                samples: subsample(samples),
+            })
+        };
+        Self {
+            version: REPORT_VERSION,
+            system: SystemReport::new(&app.system),
+            params: app.params.clone(),
+            iterations,
+            warmup,
+            rounds,
+            compared: app.final_off.is_some(),
+            calibration: app.calibration.clone(),
+            on: side(&app.final_on, &app.hist_on, &app.place_on, &app.perf_on, &app.samples_on),
+            off: side(&app.final_off, &app.hist_off, &app.place_off, &app.perf_off, &app.samples_off),
+        }
+    }
+
+    pub fn load(path: &Path) -> Result<Self, String> {
+        let text = fs::read_to_string(path).map_err(|e| format!("{}: {}", path.display(), e))?;
+        let r: Report =
+            serde_json::from_str(&text).map_err(|e| format!("{}: {}", path.display(), e))?;
+        if r.version != REPORT_VERSION {
+            return Err(format!(
+                "{}: report version {} (expected {})",
+                path.display(),
+                r.version,
+                REPORT_VERSION
+            ));
+        }
+        Ok(r)
+    }
+
+    pub fn write(&self, path: &Path, format: Format) -> io::Result<()> {
+        let mut f = io::BufWriter::new(fs::File::create(path)?);
+        match format {
+            Format::Json => {
+                serde_json::to_writer_pretty(&mut f, self)?;
+                writeln!(f)?;
+            }
+            Format::Csv => self.write_csv(&mut f)?,
+        }
+        f.flush()
+    }
+
+    fn write_csv(&self, f: &mut impl Write) -> io::Result<()> {
+        let mut header = vec![
+            "side", "scenario", "cpu_model", "kernel", "ncpus", "physical_cores", "popcnt",
+            "ctz", "ptselect", "workers", "background", "idle", "shadows_per_worker", "groups",
+            "iterations", "warmup", "rounds", "count", "mean_ns", "trimmed_mean_ns",
+            "stddev_ns", "min_ns", "max_ns", "p50_ns", "p99_ns", "ops_per_sec",
+        ]
+        .into_iter()
+        .map(String::from)
+        .collect::<Vec<_>>();
+        header.extend((0..NUM_BUCKETS).map(|b| format!("hist_{}", b)));
+        let place_rows = Placement::default().rows();
+        header.push("placement_total".into());
+        header.extend(place_rows.iter().map(|(l, _)| format!("place_{}", l.replace(' ', "_"))));
+        header.push("wakeups".into());
+        header.extend(
+            PerfCounts::default()
+                .rows()
+                .iter()
+                .map(|(l, _)| format!("{}_per_wakeup", l.replace(' ', "_"))),
+        );
+        writeln!(f, "{}", header.join(","))?;
+
+        let sys = &self.system;
+        let p = &self.params;
+        for (label, side) in [("on", &self.on), ("off", &self.off)] {
+            let Some(side) = side else { continue };
+            let st = &side.stats;
+            let mut row = vec![
+                label.to_string(),
+                p.scenario.label().to_string(),
+                csv_field(&sys.cpu_model),
+                csv_field(&sys.kernel),
+                sys.ncpus.to_string(),
+                sys.physical_cores.to_string(),
+                sys.popcnt.clone(),
+                sys.ctz.clone(),
+                sys.ptselect.clone(),
+                p.n_workers.to_string(),
+                p.n_background.to_string(),
+                p.n_idle.to_string(),
+                p.shadows_per_worker.to_string(),
+                p.n_groups.to_string(),
+                self.iterations.to_string(),
+                self.warmup.to_string(),
+                self.rounds.to_string(),
+                st.count.to_string(),
+                format!("{:.1}", st.mean),
+                format!("{:.1}", st.trimmed_mean),
+                format!("{:.1}", st.stddev),
+                st.min.to_string(),
+                st.max.to_string(),
+                st.p50.to_string(),
+                st.p99.to_string(),
+                format!("{:.0}", st.ops_per_sec()),
+            ];
+            row.extend(side.histogram.buckets.iter().map(|b| b.to_string()));
+            row.push(side.placement.total.to_string());
+            row.extend(side.placement.rows().iter().map(|(_, n)| n.to_string()));
+            row.push(side.perf.wakeups.to_string());
+            row.extend(
+                side.perf
+                    .rows()
+                    .iter()
+                    .map(|(_, v)| v.map(|v| format!("{:.3}", v)).unwrap_or_default()),
+            );
+            writeln!(f, "{}", row.join(","))?;
+        }
+        Ok(())
+    }
+}
+
+fn csv_field(s: &str) -> String {
+    if s.contains([',', '"', '\n']) {
+        format!("\"{}\"", s.replace('"', "\"\""))
+    } else {
+        s.to_string()
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Statistics for the comparison
+// ---------------------------------------------------------------------------
+
+/// Complementary error function (Numerical Recipes erfcc, |error| < 1.2e-7)
+fn erfc(x: f64) -> f64 {
+    let z = x.abs();
+    let t = 1.0 / (1.0 + 0.5 * z);
+    let r = t
+        * (-z * z - 1.26551223
+            + t * (1.00002368
+                + t * (0.37409196
+                    + t * (0.09678418
+                        + t * (-0.18628806
+                            + t * (0.27886807
+                                + t * (-1.13520398
+                                    + t * (1.48851587
+                                        + t * (-0.82215223 + t * 0.17087277)))))))))
+            .exp();
+    if x >= 0.0 {
+        r
+    } else {
+        2.0 - r
+    }
+}
+
+/// One-sided Mann-Whitney U test (normal approximation with tie
+/// correction): p-value of "candidate latencies are stochastically larger
+/// than base latencies", and the common-language effect size P(cand > base).
+fn mann_whitney(base: &[u64], cand: &[u64]) -> (f64, f64) {
+    let (n1, n2) = (base.len() as f64, cand.len() as f64);
+    let mut all: Vec<(u64, bool)> = base
+        .iter()
+        .map(|&v| (v, false))
+        .chain(cand.iter().map(|&v| (v, true)))
+        .collect();
+    all.sort_unstable_by_key(|&(v, _)| v);
+
+    // Rank sum of the candidate, ties get their average rank
+    let mut rank_sum = 0.0;
+    let mut tie_term = 0.0;
+    let mut i = 0;
+    while i < all.len() {
+        let mut j = i;
+        while j < all.len() && all[j].0 == all[i].0 {
+            j += 1;
+        }
+        let avg_rank = (i + j + 1) as f64 / 2.0; // ranks are 1-based
+        let t = (j - i) as f64;
+        tie_term += t * t * t - t;
+        rank_sum += avg_rank * all[i..j].iter().filter(|&&(_, c)| c).count() as f64;
+        i = j;
+    }
+
+    let u = rank_sum - n2 * (n2 + 1.0) / 2.0;
+    let n = n1 + n2;
+    let mean = n1 * n2 / 2.0;
+    let var = n1 * n2 / 12.0 * ((n + 1.0) - tie_term / (n * (n - 1.0)));
+    if var <= 0.0 {
+        return (1.0, 0.5);
+    }
+    let z = (u - mean - 0.5) / var.sqrt(); // continuity correction
+    (0.5 * erfc(z / std::f64::consts::SQRT_2), u / (n1 * n2))
+}
+
+fn percentile(v: &mut [u64], q: f64) -> u64 {
+    let idx = ((v.len() - 1) as f64 * q) as usize;
+    *v.select_nth_unstable(idx).1
+}
+
+/// SplitMix64: reproducible resampling without another dependency
+struct SplitMix(u64);
+
+impl SplitMix {
+    fn next(&mut self) -> u64 {
+        self.0 = self.0.wrapping_add(0x9e37_79b9_7f4a_7c15);
+        let mut z = self.0;
+        z = (z ^ (z >> 30)).wrapping_mul(0xbf58_476d_1ce4_e5b9);
+        z = (z ^ (z >> 27)).wrapping_mul(0x94d0_49bb_1331_11eb);
+        z ^ (z >> 31)
+    }
+
+    fn below(&mut self, n: usize) -> usize {
+        ((self.next() >> 32) * n as u64 >> 32) as usize
+    }
+}
+
+/// Percentile bootstrap CI of p99(cand) - p99(base), in ns
+fn bootstrap_p99_diff(base: &[u64], cand: &[u64], alpha: f64) -> (f64, f64) {
+    let mut rng = SplitMix(0x5eed);
+    let mut rb = vec![0u64; base.len()];
+    let mut rc = vec![0u64; cand.len()];
+    let mut diffs: Vec<f64> = (0..BOOTSTRAP_RESAMPLES)
+        .map(|_| {
+            for v in rb.iter_mut() {
+                *v = base[rng.below(base.len())];
+            }
+            for v in rc.iter_mut() {
+                *v = cand[rng.below(cand.len())];
+            }
+            percentile(&mut rc, 0.99) as f64 - percentile(&mut rb, 0.99) as f64
+        })
+        .collect();
+    diffs.sort_unstable_by(|a, b| a.total_cmp(b));
+    let at = |q: f64| diffs[((diffs.len() - 1) as f64 * q).round() as usize];
+    (at(alpha / 2.0), at(1.0 - alpha / 2.0))
+}
+
+// ---------------------------------------------------------------------------
+// --compare-files
+// ---------------------------------------------------------------------------
+
+pub struct GateOptions {
+    pub side_on: bool,
+    pub alpha: f64,
+    pub threshold_pct: f64,
+}
+
+/// Compare one side of two reports. Returns the process exit status:
+/// 0 = no significant regression, 1 = regression, 2 = unusable input.
+/// Both tests treat the samples as independent draws, although samples of
+/// one worker or one round are correlated; the p-value and the interval
+/// come out somewhat optimistic.
+pub fn compare_files(base_path: &Path, cand_path: &Path, opt: &GateOptions) -> i32 {
+    let (base, cand) = match (Report::load(base_path), Report::load(cand_path)) {
+        (Ok(b), Ok(c)) => (b, c),
+        (Err(e), _) | (_, Err(e)) => {
+            eprintln!("{}", e);
+            return 2;
+        }
+    };
+    let side_name = if opt.side_on { "POC ON" } else { "CFS" };
+    let sides = if opt.side_on {
+        (base.on.as_ref(), cand.on.as_ref())
+    } else {
+        (base.off.as_ref(), cand.off.as_ref())
+    };
+    let (Some(b), Some(c)) = sides else {
+        eprintln!("{} side missing from one of the reports", side_name);
+        return 2;
+    };
+    if b.samples.len() < 2 || c.samples.len() < 2 {
+        eprintln!("not enough samples to compare");
+        return 2;
+    }
+
+    println!("Base:      {} ({})", base_path.display(), base.system.kernel);
+    println!("Candidate: {} ({})", cand_path.display(), cand.system.kernel);
+    for (what, a, z) in [
+        ("CPU", base.system.cpu_model.clone(), cand.system.cpu_model.clone()),
+        (
+            "scenario",
+            base.params.scenario.label().to_string(),
+            cand.params.scenario.label().to_string(),
+        ),
+        ("workers", base.params.n_workers.to_string(), cand.params.n_workers.to_string()),
+        (
+            "background",
+            base.params.n_background.to_string(),
+            cand.params.n_background.to_string(),
+        ),
+    ] {
+        if a != z {
+            println!("warning: {} differs ({} vs {})", what, a, z);
+        }
+    }
+
+    println!();
+    println!("{} side, {} vs {} samples", side_name, b.samples.len(), c.samples.len());
+    println!("{:>12} {:>14} {:>14} {:>9}", "", "base", "candidate", "\u{0394}");
+    let rel = |a: f64, z: f64| if a != 0.0 { (z - a) / a * 100.0 } else { 0.0 };
+    for (label, a, z) in [
+        ("mean", b.stats.trimmed_mean, c.stats.trimmed_mean),
+        ("p50", b.stats.p50 as f64, c.stats.p50 as f64),
+        ("p99", b.stats.p99 as f64, c.stats.p99 as f64),
+    ] {
+        println!(
+            "{:>12} {:>11.2} μs {:>11.2} μs {:>+8.1}%",
+            label,
+            a / 1000.0,
+            z / 1000.0,
+            rel(a, z)
+        );
+    }
+
+    let (p, effect) = mann_whitney(&b.samples, &c.samples);
+    let (lo, hi) = bootstrap_p99_diff(&b.samples, &c.samples, opt.alpha);
+    let base_p99 = percentile(&mut b.samples.clone(), 0.99) as f64;
+    let median_shift = rel(
+        percentile(&mut b.samples.clone(), 0.5) as f64,
+        percentile(&mut c.samples.clone(), 0.5) as f64,
+    );
+
+    println!();
+    println!(
+        "Mann-Whitney U (candidate slower): p = {:.3e}, P(cand > base) = {:.3}",
+        p, effect
+    );
+    println!(
+        "p99 difference, {:.0}% bootstrap CI: [{:+.2}, {:+.2}] μs ([{:+.1}%, {:+.1}%])",
+        (1.0 - opt.alpha) * 100.0,
+        lo / 1000.0,
+        hi / 1000.0,
+        rel(base_p99, base_p99 + lo),
+        rel(base_p99, base_p99 + hi)
+    );
+
+    // Significant and larger than the noise floor we are willing to ignore
+    let median_regressed = p < opt.alpha && median_shift > opt.threshold_pct;
+    let tail_regressed = rel(base_p99, base_p99 + lo) > opt.threshold_pct;
+    println!();
+    if median_regressed || tail_regressed {
+        println!(
+            "REGRESSION ({}{}; alpha {}, threshold {}%)",
+            if median_regressed { "median" } else { "" },
+            match (median_regressed, tail_regressed) {
+                (true, true) => " and p99",
+                (false, true) => "p99",
+                _ => "",
+            },
+            opt.alpha,
+            opt.threshold_pct
+        );
+        1
+    } else {
+        println!(
+            "no significant regression (alpha {}, threshold {}%)",
+            opt.alpha, opt.threshold_pct
+        );
+        0
+    }
+}
@@ -1,3 +1,5 @@
+use serde::{Deserialize, Serialize};
+
 /// Log2-scaled histogram buckets in microseconds.
 /// Buckets: [0,1), [1,2), [2,4), [4,8), [8,16), [16,32), [32,64), [64,128), [128+)
 pub const NUM_BUCKETS: usize = 9;
@@ -5,7 +7,7 @@ pub const BUCKET_LABELS: [&str; NUM_BUCKETS] = [
     " <1 ", "  1 ", "  2 ", "  4 ", "  8 ", " 16 ", " 32 ", " 64 ", "128+",
 ];
 
-#[derive(Clone, Default)]
+#[derive(Clone, Default, Serialize, Deserialize)]
 pub struct StatResult {
     pub mean: f64,
     pub trimmed_mean: f64,
@@ -17,7 +19,33 @@ pub struct StatResult {
     pub count: usize,
 }
 
-#[derive(Clone, Default)]
+/// Where the woken workers landed, relative to the CPU each one woke on
+/// last time. The first five classes are exclusive and checked in order;
+/// `collided` counts wakeups that shared a CPU with another worker's
+/// wakeup of the same round.
+#[derive(Clone, Default, Serialize, Deserialize)]
+pub struct Placement {
+    pub total: u64,
+    pub same_cpu: u64,
+    pub busy_cpu: u64,
+    pub smt_busy: u64,
+    pub same_cluster: u64,
+    pub other_cluster: u64,
+    pub collided: u64,
+}
+
+pub const NR_PERF: usize = 5;
+
+/// perf_event totals of one or more runs (see perf.rs); `wakeups` includes
+/// warmup, like the counting window does.
+#[derive(Clone, Default, Serialize, Deserialize)]
+pub struct PerfCounts {
+    pub wakeups: u64,
+    pub val: [u64; NR_PERF],
+    pub failed: [bool; NR_PERF],
+}
+
+#[derive(Clone, Default, Serialize, Deserialize)]
 pub struct Histogram {
     pub buckets: [u32; NUM_BUCKETS],
     pub total: u32,
@@ -116,6 +144,63 @@ impl StatResult {
     }
 }
 
+impl Placement {
+    pub fn add(&mut self, other: &Placement) {
+        self.total += other.total;
+        self.same_cpu += other.same_cpu;
+        self.busy_cpu += other.busy_cpu;
+        self.smt_busy += other.smt_busy;
+        self.same_cluster += other.same_cluster;
+        self.other_cluster += other.other_cluster;
+        self.collided += other.collided;
+    }
+
+    /// (label, count) in display order
+    pub fn rows(&self) -> [(&'static str, u64); 6] {
+        [
+            ("same CPU", self.same_cpu),
+            ("busy CPU", self.busy_cpu),
+            ("SMT of busy", self.smt_busy),
+            ("same cluster", self.same_cluster),
+            ("other cluster", self.other_cluster),
+            ("collided", self.collided),
+        ]
+    }
+
+    pub fn pct(&self, n: u64) -> f64 {
+        if self.total == 0 {
+            0.0
+        } else {
+            n as f64 * 100.0 / self.total as f64
+        }
+    }
+}
+
+impl PerfCounts {
+    pub fn add(&mut self, other: &PerfCounts) {
+        self.wakeups += other.wakeups;
+        for i in 0..NR_PERF {
+            self.val[i] += other.val[i];
+            self.failed[i] |= other.failed[i];
+        }
+    }
+
+    /// (label, per-wakeup value or None when not counted) in display order
+    pub fn rows(&self) -> [(&'static str, Option<f64>); NR_PERF] {
+        let per = |i: usize| {
+            (!self.failed[i] && self.wakeups > 0)
+                .then(|| self.val[i] as f64 / self.wakeups as f64)
+        };
+        [
+            ("cycles", per(0)),
+            ("kernel cycles", per(1)),
+            ("ctx switches", per(2)),
+            ("migrations", per(3)),
+            ("LLC misses", per(4)),
+        ]
+    }
+}
+
 impl Histogram {
     pub fn from_samples(samples: &[u64]) -> Self {
         let mut h = Self::default();
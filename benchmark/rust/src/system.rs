@@ -1,6 +1,8 @@
+use serde::{Deserialize, Serialize};
 use std::collections::HashSet;
 use std::fs;
 use std::io::Write;
+use std::sync::OnceLock;
 
 const SYSCTL_PATH: &str = "/proc/sys/kernel/sched_poc_selector";
 
@@ -19,12 +21,47 @@ pub struct HwFeatures {
     pub ptselect: &'static str,
 }
 
-#[derive(Clone)]
+/// Per-CPU core and cluster IDs: the first CPU of thread_siblings_list and
+/// cluster_cpus_list (a CPU is its own core and cluster when sysfs does not
+/// say). Indexed by CPU number.
+pub struct CpuTopology {
+    pub core: Vec<usize>,
+    pub cluster: Vec<usize>,
+}
+
+/// Wakeup pattern a measurement round drives
+#[derive(Clone, Copy, PartialEq, Eq, clap::ValueEnum, Serialize, Deserialize)]
+#[serde(rename_all = "lowercase")]
+pub enum Scenario {
+    /// Dispatcher wakes every worker through its own eventfd
+    Burst,
+    /// Thread pairs bounce a timestamp over pipes (1:1 handoff)
+    Pipe,
+    /// One FUTEX_WAKE releases all workers at once
+    Futex,
+    /// Senders write to their receivers over AF_UNIX sockets (hackbench)
+    Fanout,
+}
+
+impl Scenario {
+    pub fn label(self) -> &'static str {
+        match self {
+            Scenario::Burst => "burst",
+            Scenario::Pipe => "pipe",
+            Scenario::Futex => "futex",
+            Scenario::Fanout => "fanout",
+        }
+    }
+}
+
+#[derive(Clone, Serialize, Deserialize)]
 pub struct BenchParams {
     pub n_workers: usize,
     pub n_background: usize,
     pub n_idle: usize,
     pub shadows_per_worker: usize,
+    pub scenario: Scenario,
+    pub n_groups: usize, // fan-out senders
 }
 
 impl SystemInfo {
@@ -75,10 +112,46 @@ impl BenchParams {
             n_background,
             n_idle,
             shadows_per_worker,
+            scenario: Scenario::Burst,
+            n_groups: 2,
         }
     }
 }
 
+impl CpuTopology {
+    fn detect() -> Self {
+        let n = unsafe { libc::sysconf(libc::_SC_NPROCESSORS_CONF) as usize };
+        let first_cpu = |cpu: usize, file: &str| -> Option<usize> {
+            let s = fs::read_to_string(format!(
+                "/sys/devices/system/cpu/cpu{cpu}/topology/{file}"
+            ))
+            .ok()?;
+            s.split(|c: char| c == ',' || c == '-')
+                .next()?
+                .trim()
+                .parse()
+                .ok()
+        };
+        let core: Vec<usize> = (0..n)
+            .map(|cpu| first_cpu(cpu, "thread_siblings_list").unwrap_or(cpu))
+            .collect();
+        let cluster = (0..n)
+            .map(|cpu| first_cpu(cpu, "cluster_cpus_list").unwrap_or(core[cpu]))
+            .collect();
+        Self { core, cluster }
+    }
+
+    pub fn nr_cpus(&self) -> usize {
+        self.core.len()
+    }
+}
+
+/// Read once, on first use
+pub fn cpu_topology() -> &'static CpuTopology {
+    static TOPO: OnceLock<CpuTopology> = OnceLock::new();
+    TOPO.get_or_init(CpuTopology::detect)
+}
+
 pub fn poc_sysctl_read() -> Option<i32> {
     fs::read_to_string(SYSCTL_PATH)
         .ok()
@@ -5,7 +5,7 @@ use ratatui::widgets::{Block, Borders, Gauge, Paragraph};
 use ratatui::Frame;
 
 use crate::calibrate::CalibrationResult;
-use crate::stats::{Histogram, StatResult, BUCKET_LABELS, NUM_BUCKETS};
+use crate::stats::{Histogram, PerfCounts, Placement, StatResult, BUCKET_LABELS, NUM_BUCKETS};
 use crate::system::{BenchParams, SystemInfo};
 
 // ---------------------------------------------------------------------------
@@ -35,6 +35,12 @@ pub struct App {
     pub hist_off: Option<Histogram>,
     pub final_on: Option<StatResult>,
     pub final_off: Option<StatResult>,
+    pub place_on: Option<Placement>,
+    pub place_off: Option<Placement>,
+    pub perf_on: Option<PerfCounts>,
+    pub perf_off: Option<PerfCounts>,
+    pub samples_on: Vec<u64>, // all measured latencies, for --output
+    pub samples_off: Vec<u64>,
     pub finished: bool,
 }
 
@@ -50,6 +56,12 @@ impl App {
             hist_off: None,
             final_on: None,
             final_off: None,
+            place_on: None,
+            place_off: None,
+            perf_on: None,
+            perf_off: None,
+            samples_on: Vec::new(),
+            samples_off: Vec::new(),
             finished: false,
         }
     }
@@ -77,6 +89,7 @@ pub fn draw(f: &mut Frame, app: &App) {
             Constraint::Length(4), // header
             Constraint::Length(3), // progress
             Constraint::Min(12),   // histogram
+            Constraint::Length(9), // placement | perf counters
             Constraint::Length(8), // summary
             Constraint::Length(1), // footer
         ])
@@ -85,8 +98,14 @@ pub fn draw(f: &mut Frame, app: &App) {
     draw_header(f, chunks[0], app);
     draw_progress(f, chunks[1], app);
     draw_histogram(f, chunks[2], app);
-    draw_summary(f, chunks[3], app);
-    draw_footer(f, chunks[4], app);
+    let row = Layout::default()
+        .direction(Direction::Horizontal)
+        .constraints([Constraint::Percentage(50), Constraint::Percentage(50)])
+        .split(chunks[3]);
+    draw_placement(f, row[0], app);
+    draw_perf(f, row[1], app);
+    draw_summary(f, chunks[4], app);
+    draw_footer(f, chunks[5], app);
 }
 
 fn draw_header(f: &mut Frame, area: Rect, app: &App) {
@@ -114,7 +133,8 @@ fn draw_header(f: &mut Frame, area: Rect, app: &App) {
         Line::from(vec![
             Span::styled(
                 format!(
-                    "{} worker{} \u{00b7} {} bg \u{00b7} {} idle \u{00b7} {} shadow/w",
+                    "{} \u{00b7} {} worker{} \u{00b7} {} bg \u{00b7} {} idle \u{00b7} {} shadow/w",
+                    app.params.scenario.label(),
                     app.params.n_workers,
                     if app.params.n_workers > 1 { "s" } else { "" },
                     app.params.n_background,
@@ -254,6 +274,132 @@ fn draw_histogram(f: &mut Frame, area: Rect, app: &App) {
     f.render_widget(paragraph, inner);
 }
 
+fn draw_placement(f: &mut Frame, area: Rect, app: &App) {
+    let block = Block::default()
+        .title(" Wakee Placement ")
+        .title_style(Style::default().fg(COL_LABEL))
+        .borders(Borders::ALL);
+    let inner = block.inner(area);
+    f.render_widget(block, area);
+
+    if app.place_on.is_none() && app.place_off.is_none() {
+        let p = Paragraph::new(Line::from(Span::styled(
+            "Waiting for results...",
+            Style::default().fg(COL_DIM),
+        )));
+        f.render_widget(p, inner);
+        return;
+    }
+
+    let mut lines = vec![Line::from(vec![
+        Span::styled(format!("{:>14}", ""), Style::default()),
+        Span::styled(
+            format!("{:>12}", "POC ON"),
+            Style::default().fg(COL_POC).add_modifier(Modifier::BOLD),
+        ),
+        Span::styled(
+            format!("{:>12}", "CFS"),
+            Style::default().fg(COL_CFS).add_modifier(Modifier::BOLD),
+        ),
+        Span::styled(
+            format!("{:>12}", "\u{0394}"),
+            Style::default()
+                .fg(Color::White)
+                .add_modifier(Modifier::BOLD),
+        ),
+    ])];
+
+    let empty = Placement::default();
+    let on = app.place_on.as_ref().unwrap_or(&empty);
+    let off = app.place_off.as_ref().unwrap_or(&empty);
+    for ((label, n_on), (_, n_off)) in on.rows().into_iter().zip(off.rows()) {
+        let (p_on, p_off) = (on.pct(n_on), off.pct(n_off));
+        let mut spans = vec![
+            Span::styled(format!("{:>14}", label), Style::default().fg(Color::White)),
+            Span::styled(format!("{:>11.1}%", p_on), Style::default().fg(COL_POC)),
+            Span::styled(format!("{:>11.1}%", p_off), Style::default().fg(COL_CFS)),
+        ];
+        if on.total > 0 && off.total > 0 {
+            spans.push(Span::styled(
+                format!("{:>+9.1} pp", p_on - p_off),
+                Style::default().fg(COL_DIM),
+            ));
+        }
+        lines.push(Line::from(spans));
+    }
+
+    let paragraph = Paragraph::new(lines);
+    f.render_widget(paragraph, inner);
+}
+
+fn draw_perf(f: &mut Frame, area: Rect, app: &App) {
+    let block = Block::default()
+        .title(" Per Wakeup (perf_event) ")
+        .title_style(Style::default().fg(COL_LABEL))
+        .borders(Borders::ALL);
+    let inner = block.inner(area);
+    f.render_widget(block, area);
+
+    if app.perf_on.is_none() && app.perf_off.is_none() {
+        let p = Paragraph::new(Line::from(Span::styled(
+            "Waiting for results...",
+            Style::default().fg(COL_DIM),
+        )));
+        f.render_widget(p, inner);
+        return;
+    }
+
+    let mut lines = vec![Line::from(vec![
+        Span::styled(format!("{:>14}", ""), Style::default()),
+        Span::styled(
+            format!("{:>12}", "POC ON"),
+            Style::default().fg(COL_POC).add_modifier(Modifier::BOLD),
+        ),
+        Span::styled(
+            format!("{:>12}", "CFS"),
+            Style::default().fg(COL_CFS).add_modifier(Modifier::BOLD),
+        ),
+        Span::styled(
+            format!("{:>10}", "\u{0394}"),
+            Style::default()
+                .fg(Color::White)
+                .add_modifier(Modifier::BOLD),
+        ),
+    ])];
+
+    let empty = PerfCounts::default();
+    let on = app.perf_on.as_ref().unwrap_or(&empty);
+    let off = app.perf_off.as_ref().unwrap_or(&empty);
+    for ((label, v_on), (_, v_off)) in on.rows().into_iter().zip(off.rows()) {
+        let mut spans = vec![
+            Span::styled(format!("{:>14}", label), Style::default().fg(Color::White)),
+            Span::styled(format!("{:>12}", format_perf(v_on)), Style::default().fg(COL_POC)),
+            Span::styled(format!("{:>12}", format_perf(v_off)), Style::default().fg(COL_CFS)),
+        ];
+        if let (Some(a), Some(b)) = (v_on, v_off) {
+            if b > 0.0 {
+                let delta = (a - b) / b * 100.0;
+                // Fewer cycles, switches, migrations and misses are better
+                let col = if delta <= 0.0 { COL_BETTER } else { COL_WORSE };
+                spans.push(Span::styled(format!("{:>+9.1}%", delta), Style::default().fg(col)));
+            }
+        }
+        lines.push(Line::from(spans));
+    }
+
+    let paragraph = Paragraph::new(lines);
+    f.render_widget(paragraph, inner);
+}
+
+/// Per-wakeup counter value: integers for large counts, "n/a" if not counted
+fn format_perf(v: Option<f64>) -> String {
+    match v {
+        None => "n/a".to_string(),
+        Some(v) if v >= 100.0 => format!("{:.0}", v),
+        Some(v) => format!("{:.3}", v),
+    }
+}
+
 fn draw_summary(f: &mut Frame, area: Rect, app: &App) {
     let block = Block::default()
         .title(" Summary ")
@@ -454,7 +600,8 @@ pub fn print_summary(app: &App) {
         hw.popcnt, hw.ctz, hw.ptselect
     );
     println!(
-        "Config: {} CPUs, {} workers, {} bg, {} idle, {} shadows/w",
+        "Config: {} scenario, {} CPUs, {} workers, {} bg, {} idle, {} shadows/w",
+        app.params.scenario.label(),
         app.system.ncpus,
         app.params.n_workers,
         app.params.n_background,
@@ -500,5 +647,32 @@ pub fn print_summary(app: &App) {
             println!("{:>12} {:>14} {:>14} {:>+8.1}%", label, on_s, off_s, delta);
         }
     }
+
+    if app.place_on.is_some() || app.place_off.is_some() {
+        let empty = Placement::default();
+        let on = app.place_on.as_ref().unwrap_or(&empty);
+        let off = app.place_off.as_ref().unwrap_or(&empty);
+        println!();
+        println!("{:>14} {:>12} {:>12}", "wakee landed", "POC ON", "CFS");
+        for ((label, n_on), (_, n_off)) in on.rows().into_iter().zip(off.rows()) {
+            println!(
+                "{:>14} {:>11.1}% {:>11.1}%",
+                label,
+                on.pct(n_on),
+                off.pct(n_off)
+            );
+        }
+    }
+
+    if app.perf_on.is_some() || app.perf_off.is_some() {
+        let empty = PerfCounts::default();
+        let on = app.perf_on.as_ref().unwrap_or(&empty);
+        let off = app.perf_off.as_ref().unwrap_or(&empty);
+        println!();
+        println!("{:>14} {:>12} {:>12}", "per wakeup", "POC ON", "CFS");
+        for ((label, v_on), (_, v_off)) in on.rows().into_iter().zip(off.rows()) {
+            println!("{:>14} {:>12} {:>12}", label, format_perf(v_on), format_perf(v_off));
+        }
+    }
     println!();
 }
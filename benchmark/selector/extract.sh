@@ -0,0 +1,44 @@
+#!/bin/sh
+# SPDX-License-Identifier: GPL-2.0
+#
+# extract.sh PATCH OUTDIR
+#
+# Pull the selector sources out of the POC patch, so the harness always
+# builds the code the patch ships:
+#   OUTDIR/kernel/sched/poc_selector.c
+#   OUTDIR/include/trace/events/poc_selector.h
+#   OUTDIR/poc_sds_fields.h   (POC members of struct sched_domain_shared)
+#
+set -e
+patch=$1
+out=$2
+
+[ -r "$patch" ] || { echo "extract.sh: cannot read $patch" >&2; exit 1; }
+
+# Added lines of a file the patch creates
+newfile() {
+	awk -v f="a/$1" '
+		/^diff --git / { on = ($3 == f); body = 0; next }
+		on && /^@@ / { body = 1; next }
+		on && body && /^\+/ { print substr($0, 2) }
+	' "$patch"
+}
+
+# Added lines of the topology.h hunk inside struct sched_domain_shared
+sds_fields() {
+	awk '
+		/^diff --git / { on = ($3 == "a/include/linux/sched/topology.h"); next }
+		on && /^@@ / { h = /struct sched_domain_shared/; next }
+		on && h && /^\+/ { print substr($0, 2) }
+	' "$patch"
+}
+
+mkdir -p "$out/kernel/sched" "$out/include/trace/events"
+newfile kernel/sched/poc_selector.c > "$out/kernel/sched/poc_selector.c"
+newfile include/trace/events/poc_selector.h > "$out/include/trace/events/poc_selector.h"
+sds_fields > "$out/poc_sds_fields.h"
+
+for f in kernel/sched/poc_selector.c include/trace/events/poc_selector.h \
+	 poc_sds_fields.h; do
+	[ -s "$out/$f" ] || { echo "extract.sh: $f not found in $patch" >&2; exit 1; }
+done
@@ -0,0 +1,11 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+/*
+ * Userspace stand-in for <linux/sched/wake_q.h>: only the list
+ * terminator the wake-many batch walks to.
+ */
+#ifndef _POC_SHIM_WAKE_Q_H
+#define _POC_SHIM_WAKE_Q_H
+
+#define WAKE_Q_TAIL	((struct wake_q_node *)0x01)
+
+#endif
@@ -0,0 +1,18 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+/*
+ * Userspace stand-in for <linux/tracepoint.h>: every POC tracepoint
+ * becomes an empty inline, and is never enabled.
+ */
+#ifndef _POC_SHIM_TRACEPOINT_H
+#define _POC_SHIM_TRACEPOINT_H
+
+#define TP_PROTO(args...)	args
+#define TP_ARGS(args...)	args
+#define TRACE_DEFINE_ENUM(x)
+
+#endif /* _POC_SHIM_TRACEPOINT_H */
+
+#undef TRACE_EVENT_FN
+#define TRACE_EVENT_FN(name, proto, args, tstruct, assign, print, reg, unreg) \
+static inline void trace_##name(proto) { }				\
+static inline bool trace_##name##_enabled(void) { return false; }
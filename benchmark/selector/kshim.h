@@ -0,0 +1,406 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+/*
+ * POC Selector Harness: userspace stand-ins for the kernel APIs used by
+ * kernel/sched/poc_selector.c
+ *
+ * Just enough of the kernel to run the selector core in a single
+ * userspace thread: atomics map to GCC __atomic builtins, static keys
+ * to plain flags, per-CPU variables to NR_CPUS arrays indexed by the
+ * simulated CPU (shim_cpu), RCU and cpus_read_lock() to nothing.
+ * Scheduler state the selector only queries (idle_cpu(), cpu_rq(), ...)
+ * is answered by poc_harness.c from its simulated topology.
+ *
+ * Only the configuration built by the Makefile is covered: SMP, SMT,
+ * cluster, cgroup placement, CONFIG_NR_CPUS=512; no sysctl, sysfs,
+ * debug counters or sched_ext.
+ */
+#ifndef _POC_KSHIM_H
+#define _POC_KSHIM_H
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <time.h>
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+/* ------------------------------------------------------------------ */
+/*  Types and compiler helpers                                         */
+/* ------------------------------------------------------------------ */
+
+typedef uint64_t u64;
+typedef int64_t  s64;
+typedef uint32_t u32;
+typedef int32_t  s32;
+typedef uint16_t u16;
+typedef uint8_t  u8;
+
+#undef __always_inline
+#define __always_inline		inline __attribute__((always_inline))
+#define noinline		__attribute__((noinline))
+#define __init
+#define __read_mostly
+#define __percpu
+#define __rcu
+#define __maybe_unused		__attribute__((unused))
+#define SMP_CACHE_BYTES		64
+#define ____cacheline_aligned	__attribute__((aligned(SMP_CACHE_BYTES)))
+
+#define likely(x)		__builtin_expect(!!(x), 1)
+#define unlikely(x)		__builtin_expect(!!(x), 0)
+#define READ_ONCE(x)		(*(const volatile __typeof__(x) *)&(x))
+#define WRITE_ONCE(x, v)	(*(volatile __typeof__(x) *)&(x) = (v))
+#define BUILD_BUG_ON(c)		_Static_assert(!(c), #c)
+#define ARRAY_SIZE(a)		(sizeof(a) / sizeof((a)[0]))
+#define DIV_ROUND_UP(n, d)	(((n) + (d) - 1) / (d))
+#define min(a, b)		((a) < (b) ? (a) : (b))
+#define max(a, b)		((a) > (b) ? (a) : (b))
+#define clamp(v, lo, hi)	min(max(v, lo), hi)
+
+#define BITS_PER_LONG		64
+#define hweight64(x)		__builtin_popcountll(x)
+#define hweight_long(x)		__builtin_popcountl(x)
+#define is_power_of_2(n)	((n) != 0 && ((n) & ((n) - 1)) == 0)
+#define ilog2(n)		(63 - __builtin_clzll(n))
+#define fls64(x)		((x) ? 64 - __builtin_clzll(x) : 0)
+
+#define EXPORT_SYMBOL_GPL(x)
+#define pr_info(...)		printf(__VA_ARGS__)
+#define pr_info_once(...)	printf(__VA_ARGS__)
+#define pr_warn(...)		fprintf(stderr, __VA_ARGS__)
+#define WARN_ON_ONCE(x)		(x)
+
+/* Initcalls are run by poc_harness.c in the order it needs them */
+#define early_initcall(f)	static int (*const f##_initcall)(void) __maybe_unused = f
+#define late_initcall(f)	early_initcall(f)
+
+/* ------------------------------------------------------------------ */
+/*  CPUs, cpumasks and per-CPU data                                    */
+/* ------------------------------------------------------------------ */
+
+#define CONFIG_NR_CPUS		512
+#define NR_CPUS			CONFIG_NR_CPUS
+#define nr_cpu_ids		((unsigned int)NR_CPUS)
+
+struct cpumask { unsigned long bits[NR_CPUS / BITS_PER_LONG]; };
+#define cpumask_bits(m)		((m)->bits)
+
+static inline bool cpumask_test_cpu(int cpu, const struct cpumask *m)
+{
+	return (m->bits[cpu / BITS_PER_LONG] >> (cpu % BITS_PER_LONG)) & 1;
+}
+
+static inline void cpumask_set_cpu(int cpu, struct cpumask *m)
+{
+	m->bits[cpu / BITS_PER_LONG] |= 1UL << (cpu % BITS_PER_LONG);
+}
+
+static inline void cpumask_clear(struct cpumask *m)
+{
+	memset(m, 0, sizeof(*m));
+}
+
+static inline int cpumask_next(int n, const struct cpumask *m)
+{
+	for (n++; n < NR_CPUS; n++)
+		if (cpumask_test_cpu(n, m))
+			return n;
+	return NR_CPUS;
+}
+
+#define cpumask_first(m)	cpumask_next(-1, (m))
+#define for_each_cpu(c, m) \
+	for ((c) = cpumask_first(m); (c) < NR_CPUS; (c) = cpumask_next((c), (m)))
+
+static inline int cpumask_last(const struct cpumask *m)
+{
+	int c;
+
+	for (c = NR_CPUS - 1; c >= 0; c--)
+		if (cpumask_test_cpu(c, m))
+			return c;
+	return NR_CPUS;
+}
+
+static inline int cpumask_weight(const struct cpumask *m)
+{
+	int i, w = 0;
+
+	for (i = 0; i < NR_CPUS / BITS_PER_LONG; i++)
+		w += hweight_long(m->bits[i]);
+	return w;
+}
+
+static inline bool cpumask_subset(const struct cpumask *a,
+				  const struct cpumask *b)
+{
+	int i;
+
+	for (i = 0; i < NR_CPUS / BITS_PER_LONG; i++)
+		if (a->bits[i] & ~b->bits[i])
+			return false;
+	return true;
+}
+
+static inline bool cpumask_intersects(const struct cpumask *a,
+				      const struct cpumask *b)
+{
+	int i;
+
+	for (i = 0; i < NR_CPUS / BITS_PER_LONG; i++)
+		if (a->bits[i] & b->bits[i])
+			return true;
+	return false;
+}
+
+static inline unsigned long bitmap_read(const unsigned long *map,
+					unsigned long start,
+					unsigned long nbits)
+{
+	unsigned long idx = start / BITS_PER_LONG, off = start % BITS_PER_LONG;
+	unsigned long v = map[idx] >> off;
+
+	if (off && off + nbits > BITS_PER_LONG && idx + 1 < NR_CPUS / BITS_PER_LONG)
+		v |= map[idx + 1] << (BITS_PER_LONG - off);
+	return nbits < BITS_PER_LONG ? v & ((1UL << nbits) - 1) : v;
+}
+
+static inline int bitmap_weight(const unsigned long *map, unsigned int nbits)
+{
+	unsigned int i, w = 0;
+
+	for (i = 0; i < nbits; i++)
+		w += (map[i / BITS_PER_LONG] >> (i % BITS_PER_LONG)) & 1;
+	return w;
+}
+
+/* The simulated CPU the harness is "running" on */
+extern int shim_cpu;
+#define smp_processor_id()	shim_cpu
+#define raw_smp_processor_id()	shim_cpu
+#define for_each_possible_cpu(c) for ((c) = 0; (c) < NR_CPUS; (c)++)
+extern const struct cpumask *cpu_online_mask;
+#define for_each_online_cpu(c)	for_each_cpu(c, cpu_online_mask)
+
+#define DEFINE_PER_CPU(t, n)		__typeof__(t) n[NR_CPUS]
+#define DEFINE_PER_CPU_ALIGNED(t, n)	DEFINE_PER_CPU(t, n)
+#define DEFINE_PER_CPU_READ_MOSTLY(t, n) DEFINE_PER_CPU(t, n)
+#define DECLARE_PER_CPU(t, n)		extern __typeof__(t) n[NR_CPUS]
+#define per_cpu(v, cpu)			((v)[cpu])
+#define per_cpu_ptr(p, cpu)		(&(*(p))[cpu])
+#define this_cpu_ptr(p)			per_cpu_ptr(p, shim_cpu)
+#define __this_cpu_read(v)		((v)[shim_cpu])
+#define __this_cpu_write(v, x)		((v)[shim_cpu] = (x))
+#define this_cpu_xchg(v, x)		__atomic_exchange_n(&(v)[shim_cpu], (x), __ATOMIC_RELAXED)
+#define __this_cpu_inc(v)		((v)[shim_cpu]++)
+#define __this_cpu_inc_return(v)	(++(v)[shim_cpu])
+#define this_cpu_inc(v)			__this_cpu_inc(v)
+
+/* ------------------------------------------------------------------ */
+/*  Atomics                                                            */
+/* ------------------------------------------------------------------ */
+
+typedef struct { s64 counter; } atomic64_t;
+typedef struct { int counter; } atomic_t;
+
+#define __SHIM_RMW(op, fetch)	__atomic_##fetch(&v->counter, op, __ATOMIC_SEQ_CST)
+
+static inline s64 atomic64_read(const atomic64_t *v) { return __atomic_load_n(&v->counter, __ATOMIC_RELAXED); }
+static inline void atomic64_set(atomic64_t *v, s64 i) { __atomic_store_n(&v->counter, i, __ATOMIC_RELAXED); }
+static inline void atomic64_or(s64 i, atomic64_t *v) { __SHIM_RMW(i, fetch_or); }
+static inline void atomic64_andnot(s64 i, atomic64_t *v) { __SHIM_RMW(~i, fetch_and); }
+static inline void atomic64_inc(atomic64_t *v) { __SHIM_RMW(1, fetch_add); }
+static inline s64 atomic64_fetch_or(s64 i, atomic64_t *v) { return __SHIM_RMW(i, fetch_or); }
+static inline s64 atomic64_fetch_andnot(s64 i, atomic64_t *v) { return __SHIM_RMW(~i, fetch_and); }
+static inline bool atomic64_try_cmpxchg(atomic64_t *v, s64 *old, s64 new)
+{
+	return __atomic_compare_exchange_n(&v->counter, old, new, false,
+					   __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+static inline int atomic_read(const atomic_t *v) { return __atomic_load_n(&v->counter, __ATOMIC_RELAXED); }
+static inline void atomic_set(atomic_t *v, int i) { __atomic_store_n(&v->counter, i, __ATOMIC_RELAXED); }
+static inline void atomic_inc(atomic_t *v) { __SHIM_RMW(1, fetch_add); }
+static inline void atomic_add(int i, atomic_t *v) { __SHIM_RMW(i, fetch_add); }
+static inline int atomic_inc_return(atomic_t *v) { return __SHIM_RMW(1, add_fetch); }
+static inline void atomic_or(int i, atomic_t *v) { __SHIM_RMW(i, fetch_or); }
+static inline void atomic_andnot(int i, atomic_t *v) { __SHIM_RMW(~i, fetch_and); }
+static inline int atomic_fetch_or(int i, atomic_t *v) { return __SHIM_RMW(i, fetch_or); }
+static inline int atomic_fetch_andnot(int i, atomic_t *v) { return __SHIM_RMW(~i, fetch_and); }
+
+#define smp_mb()		__atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define smp_mb__after_atomic()	__atomic_signal_fence(__ATOMIC_SEQ_CST)
+#define smp_wmb()		__atomic_thread_fence(__ATOMIC_RELEASE)
+#define smp_rmb()		__atomic_thread_fence(__ATOMIC_ACQUIRE)
+#define smp_load_acquire(p)	__atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define smp_store_release(p, v)	__atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+/* ------------------------------------------------------------------ */
+/*  Static keys, RCU, locking                                          */
+/* ------------------------------------------------------------------ */
+
+struct static_key_true  { int enabled; };
+struct static_key_false { int enabled; };
+#define DEFINE_STATIC_KEY_TRUE(n)	struct static_key_true n = { 1 }
+#define DEFINE_STATIC_KEY_FALSE(n)	struct static_key_false n = { 0 }
+#define static_branch_likely(k)		likely((k)->enabled > 0)
+#define static_branch_unlikely(k)	unlikely((k)->enabled > 0)
+#define static_key_enabled(k)		((k)->enabled > 0)
+#define static_branch_enable(k)		((k)->enabled = 1)
+#define static_branch_disable(k)	((k)->enabled = 0)
+#define static_branch_inc(k)		((k)->enabled++)
+#define static_branch_dec(k)		((k)->enabled--)
+#define static_branch_enable_cpuslocked(k)	static_branch_enable(k)
+#define static_branch_disable_cpuslocked(k)	static_branch_disable(k)
+
+extern struct static_key_false sched_smt_present;
+extern struct static_key_false sched_cluster_active;
+extern struct static_key_false sched_asym_cpucapacity;
+#define sched_smt_active()		static_branch_likely(&sched_smt_present)
+#define sched_asym_cpucap_active()	static_branch_unlikely(&sched_asym_cpucapacity)
+
+#define rcu_dereference(p)		(p)
+#define rcu_read_lock()			do { } while (0)
+#define preempt_disable()		do { } while (0)
+#define preempt_enable()		do { } while (0)
+#define barrier()			__asm__ __volatile__("" ::: "memory")
+#define rcu_read_unlock()		do { } while (0)
+#define guard(name)			__shim_guard
+#define __shim_guard(...)		do { } while (0)
+#define scoped_guard(name, ...)		for (int __sg = 1; __sg; __sg = 0)
+#define cpus_read_lock()		do { } while (0)
+#define cpus_read_unlock()		do { } while (0)
+#define lockdep_assert_cpus_held()	do { } while (0)
+
+/* ------------------------------------------------------------------ */
+/*  Scheduler state answered by the harness                            */
+/* ------------------------------------------------------------------ */
+
+#define WF_SYNC			0x10
+#define PF_EXITING		0x00000004
+#define NSEC_PER_USEC		1000L
+
+struct sched_entity { u64 sum_exec_runtime, prev_sum_exec_runtime; };
+struct cgroup_subsys_state { int id; };
+struct task_group {
+	struct cgroup_subsys_state css;
+	int			poc_placement;
+};
+struct wake_q_node { struct wake_q_node *next; };
+struct task_struct {
+	int			nr_cpus_allowed;
+	const struct cpumask	*cpus_ptr;
+	unsigned int		flags;
+	struct sched_entity	se;
+	struct task_group	*sched_task_group;
+	struct wake_q_node	wake_q;
+};
+extern struct task_struct *current;
+#define task_group(p)		((p)->sched_task_group)
+
+/* cpu.poc_placement handlers: every file is the wakee's group */
+struct seq_file;
+struct kernfs_open_file;
+#define container_of(ptr, type, member) \
+	((type *)((char *)(ptr) - offsetof(type, member)))
+extern struct cgroup_subsys_state *seq_css(struct seq_file *sf);
+extern struct cgroup_subsys_state *of_css(struct kernfs_open_file *of);
+static inline void seq_printf(struct seq_file *sf, const char *fmt, ...) { }
+static inline char *strstrip(char *s) { return s; }
+
+static inline int __sysfs_match_string(const char * const *array, size_t n,
+				       const char *str)
+{
+	for (size_t i = 0; i < n; i++)
+		if (array[i] && !strcmp(array[i], str))
+			return (int)i;
+	return -EINVAL;
+}
+#define sysfs_match_string(a, s)	__sysfs_match_string(a, ARRAY_SIZE(a), s)
+
+struct cfs_rq { unsigned int h_nr_idle; };
+struct rq { unsigned int nr_running; struct cfs_rq cfs; int cpu; };
+
+struct sched_domain_shared {
+	atomic_t	ref;
+	atomic_t	nr_busy_cpus;
+	int		has_idle_cores;
+	int		nr_idle_scan;
+#include "poc_sds_fields.h"	/* generated from the patch by the Makefile */
+};
+
+DECLARE_PER_CPU(struct sched_domain_shared *, sd_llc_shared);
+DECLARE_PER_CPU(int, sd_llc_size);
+DECLARE_PER_CPU(int, sd_llc_id);
+
+extern struct static_key_true sched_poc_enabled;
+extern struct static_key_true sched_poc_asym_capacity;
+
+/* kernel/sched/sched.h */
+static __always_inline bool sched_poc_active(void)
+{
+	return static_branch_likely(&sched_poc_enabled) &&
+	       (!sched_asym_cpucap_active() ||
+		static_branch_likely(&sched_poc_asym_capacity));
+}
+
+static inline int poc_span_bit(const struct cpumask *span, int base,
+			       bool remapped, int cpu)
+{
+	if (!remapped)
+		return cpu - base;
+	if (!cpumask_test_cpu(cpu, span))
+		return -1;
+	return bitmap_weight(cpumask_bits(span), cpu);
+}
+
+extern const struct cpumask *cpu_smt_mask(int cpu);
+extern const struct cpumask *cpu_clustergroup_mask(int cpu);
+extern const struct cpumask *cpumask_of_node(int node);
+extern int cpu_to_node(int cpu);
+extern int idle_cpu(int cpu);
+extern int available_idle_cpu(int cpu);
+extern int sched_idle_cpu(int cpu);
+extern int sched_idle_rq(struct rq *rq);
+extern struct rq *cpu_rq(int cpu);
+extern int cpu_of(struct rq *rq);
+extern int util_fits_cpu(unsigned long util, unsigned long uclamp_min,
+			 unsigned long uclamp_max, int cpu);
+
+/* ------------------------------------------------------------------ */
+/*  Cycle counter and boot CPU features                                */
+/* ------------------------------------------------------------------ */
+
+typedef u64 cycles_t;
+
+static inline cycles_t get_cycles(void)
+{
+#if defined(__x86_64__)
+	return __rdtsc();
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (u64)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+#define X86_FEATURE_POPCNT	0
+#define X86_FEATURE_BMI1	1
+#define X86_FEATURE_BMI2	2
+#define X86_VENDOR_INTEL	0
+#define X86_VENDOR_AMD		2
+#define X86_VENDOR_HYGON	9
+
+struct cpuinfo_x86 { int x86_vendor; int x86; };
+extern struct cpuinfo_x86 boot_cpu_data;
+extern bool boot_cpu_has(int feature);
+
+#endif /* _POC_KSHIM_H */
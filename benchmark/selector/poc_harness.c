@@ -0,0 +1,511 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * POC Selector Harness: the selector core of kernel/sched/poc_selector.c
+ * built for userspace (see poc_harness.h)
+ *
+ * Built twice by the Makefile: with the bit primitive tiers the kernel
+ * would pick on this CPU (poc_harness.o), and with HARNESS_SW_BITOPS,
+ * which hides the architecture from poc_selector.c so that it compiles
+ * its portable tiers -- De Bruijn CTZ and the PTSelect loop
+ * (poc_harness_sw.o).
+ */
+#include "kshim.h"
+#include "poc_harness.h"
+#if defined(__x86_64__)
+#include <cpuid.h>
+#define HARNESS_TSC
+#endif
+
+/* ------------------------------------------------------------------ */
+/*  Kernel state the selector reads                                    */
+/* ------------------------------------------------------------------ */
+
+int shim_cpu;
+struct task_struct *current;
+struct cpuinfo_x86 boot_cpu_data;
+
+DEFINE_STATIC_KEY_FALSE(sched_smt_present);
+DEFINE_STATIC_KEY_FALSE(sched_cluster_active);
+DEFINE_STATIC_KEY_FALSE(sched_asym_cpucapacity);
+
+DEFINE_PER_CPU(struct sched_domain_shared *, sd_llc_shared);
+DEFINE_PER_CPU(int, sd_llc_size);
+DEFINE_PER_CPU(int, sd_llc_id);
+
+#ifdef HARNESS_SW_BITOPS
+#undef __x86_64__
+#undef __BMI__
+#undef __aarch64__
+#undef __riscv
+#endif
+
+#include "kernel/sched/poc_selector.c"
+
+/* ------------------------------------------------------------------ */
+/*  Simulated LLC                                                      */
+/* ------------------------------------------------------------------ */
+
+static struct harness_topo topo;
+static struct sched_domain_shared llc_sds;
+static struct cpumask llc_mask;
+static struct cpumask smt_masks[NR_CPUS];
+static struct cpumask cluster_masks[NR_CPUS];
+static bool cpu_idle_state[NR_CPUS];
+static bool cpu_queued[NR_CPUS];
+static struct rq rqs[NR_CPUS];
+static struct task_struct wakee;
+static struct task_group wakee_tg;
+const struct cpumask *cpu_online_mask = &llc_mask;
+
+const struct cpumask *cpu_smt_mask(int cpu) { return &smt_masks[cpu]; }
+const struct cpumask *cpu_clustergroup_mask(int cpu) { return &cluster_masks[cpu]; }
+const struct cpumask *cpumask_of_node(int node) { return &llc_mask; }
+int cpu_to_node(int cpu) { return 0; }
+int idle_cpu(int cpu) { return cpu_idle_state[cpu] && !cpu_queued[cpu]; }
+int available_idle_cpu(int cpu) { return idle_cpu(cpu); }
+int sched_idle_cpu(int cpu) { return 0; }
+int sched_idle_rq(struct rq *rq) { return 0; }
+struct rq *cpu_rq(int cpu) { return &rqs[cpu]; }
+int cpu_of(struct rq *rq) { return rq->cpu; }
+
+int util_fits_cpu(unsigned long util, unsigned long uclamp_min,
+		  unsigned long uclamp_max, int cpu)
+{
+	return 1;
+}
+
+bool boot_cpu_has(int feature)
+{
+#if defined(HARNESS_TSC)
+	switch (feature) {
+	case X86_FEATURE_POPCNT: return __builtin_cpu_supports("popcnt");
+	case X86_FEATURE_BMI1:   return __builtin_cpu_supports("bmi");
+	case X86_FEATURE_BMI2:   return __builtin_cpu_supports("bmi2");
+	}
+#endif
+	return false;
+}
+
+static void harness_detect_cpu(void)
+{
+#if defined(HARNESS_TSC)
+	unsigned int eax, ebx, ecx, edx;
+	char vendor[13];
+
+	if (!__get_cpuid(0, &eax, &ebx, &ecx, &edx))
+		return;
+	memcpy(vendor, &ebx, 4);
+	memcpy(vendor + 4, &edx, 4);
+	memcpy(vendor + 8, &ecx, 4);
+	vendor[12] = '\0';
+	if (!strcmp(vendor, "AuthenticAMD"))
+		boot_cpu_data.x86_vendor = X86_VENDOR_AMD;
+	else if (!strcmp(vendor, "HygonGenuine"))
+		boot_cpu_data.x86_vendor = X86_VENDOR_HYGON;
+	else
+		boot_cpu_data.x86_vendor = X86_VENDOR_INTEL;
+
+	if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+		int family = (eax >> 8) & 0xf;
+
+		if (family == 0xf)
+			family += (eax >> 20) & 0xff;
+		boot_cpu_data.x86 = family;
+	}
+#endif
+}
+
+/*
+ * harness_build_sds - What sd_init() computes for a contiguous LLC
+ *
+ * SMT siblings and clusters are naturally aligned power-of-2 groups of
+ * adjacent CPU IDs, so nothing straddles a mask word and the spill
+ * masks stay empty.
+ */
+static void harness_build_sds(struct sched_domain_shared *sds)
+{
+	int n = topo.nr_cpus;
+	int cpu, other;
+
+	memset(sds, 0, sizeof(*sds));
+	sds->poc_cpu_base = 0;
+	sds->poc_remapped = false;
+	sds->poc_nr_bits = n;
+	for (cpu = 0; cpu < n; cpu++)
+		sds->poc_bit_cpu[cpu] = cpu;
+	sds->poc_nr_words = DIV_ROUND_UP(n, 64);
+	sds->poc_fast_eligible = true;
+
+	for (cpu = 0; cpu < n; cpu++) {
+		u64 sib = 0, cls = 0;
+
+		for_each_cpu(other, &smt_masks[cpu])
+			if (other != cpu)
+				sib |= 1ULL << (other & 63);
+		for_each_cpu(other, &cluster_masks[cpu])
+			if (other != cpu)
+				cls |= 1ULL << (other & 63);
+		sds->poc_smt_siblings[cpu] = sib;
+		sds->poc_cluster_mask[cpu] = cls;
+	}
+
+	sds->poc_cluster_valid = topo.cluster > topo.smt;
+	sds->poc_cluster_shift = sds->poc_cluster_valid ? ilog2(topo.cluster) : 0;
+	sds->poc_shard_shift = clamp(sds->poc_cluster_valid ?
+				     sds->poc_cluster_shift : 0, 4, 6);
+
+	if (sds->poc_nr_words > 1)
+		static_branch_disable(&sched_poc_single_word);
+	else
+		static_branch_enable(&sched_poc_single_word);
+	if (sds->poc_nr_words > 2)
+		static_branch_enable(&sched_poc_multi_word);
+	else
+		static_branch_disable(&sched_poc_multi_word);
+}
+
+int harness_init(const struct harness_topo *t)
+{
+	static bool hw_done;
+	int cpu, i;
+
+	if (t->nr_cpus < 1 || t->nr_cpus > HARNESS_MAX_CPUS ||
+	    t->smt < 1 || t->smt > 8 || !is_power_of_2(t->smt) ||
+	    t->nr_cpus % t->smt ||
+	    (t->cluster && (!is_power_of_2(t->cluster) || t->cluster > 64 ||
+			    t->cluster < t->smt || t->nr_cpus % t->cluster)))
+		return -EINVAL;
+
+	if (!hw_done) {
+		harness_detect_cpu();
+		sched_poc_hw_init();
+		hw_done = true;
+	}
+
+	topo = *t;
+	cpumask_clear(&llc_mask);
+	for (cpu = 0; cpu < NR_CPUS; cpu++) {
+		cpumask_clear(&smt_masks[cpu]);
+		cpumask_clear(&cluster_masks[cpu]);
+		cpu_idle_state[cpu] = false;
+		cpu_queued[cpu] = false;
+		per_cpu(poc_claim_pending, cpu) = 0;
+		rqs[cpu].cpu = cpu;
+		sd_llc_shared[cpu] = NULL;
+	}
+	for (cpu = 0; cpu < topo.nr_cpus; cpu++) {
+		int core = cpu - cpu % topo.smt;
+		int cls = topo.cluster ? cpu - cpu % topo.cluster : cpu;
+		int cls_size = topo.cluster ? topo.cluster : 1;
+
+		cpumask_set_cpu(cpu, &llc_mask);
+		for (i = 0; i < topo.smt; i++)
+			cpumask_set_cpu(core + i, &smt_masks[cpu]);
+		for (i = 0; i < cls_size; i++)
+			cpumask_set_cpu(cls + i, &cluster_masks[cpu]);
+	}
+
+	if (topo.smt > 1)
+		static_branch_enable(&sched_smt_present);
+	else
+		static_branch_disable(&sched_smt_present);
+	if (topo.cluster > topo.smt)
+		static_branch_enable(&sched_cluster_active);
+	else
+		static_branch_disable(&sched_cluster_active);
+
+	harness_build_sds(&llc_sds);
+	for (cpu = 0; cpu < topo.nr_cpus; cpu++) {
+		sd_llc_shared[cpu] = &llc_sds;
+		sd_llc_size[cpu] = topo.nr_cpus;
+		sd_llc_id[cpu] = 0;
+		poc_update_cpu_cache(cpu, &llc_sds);
+	}
+	sched_poc_rr_init();
+
+	wakee.nr_cpus_allowed = topo.nr_cpus;
+	wakee.cpus_ptr = &llc_mask;
+	wakee.sched_task_group = &wakee_tg;
+	current = &wakee;
+	shim_cpu = 0;
+	return 0;
+}
+
+const struct harness_topo *harness_topo(void)
+{
+	return &topo;
+}
+
+int harness_nr_words(void)
+{
+	return llc_sds.poc_nr_words;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Occupancy and selection                                            */
+/* ------------------------------------------------------------------ */
+
+void harness_set_idle(int cpu, bool idle)
+{
+	int saved = shim_cpu;
+
+	/* do_idle() runs on the CPU that changes state */
+	cpu_idle_state[cpu] = idle;
+	shim_cpu = cpu;
+	__set_cpu_idle_state(cpu, idle);
+	shim_cpu = saved;
+}
+
+bool harness_cpu_idle(int cpu)
+{
+	return cpu_idle_state[cpu];
+}
+
+void harness_set_queued(int cpu, bool queued)
+{
+	cpu_queued[cpu] = queued;
+}
+
+void harness_fill(bool idle)
+{
+	int cpu;
+
+	for (cpu = 0; cpu < topo.nr_cpus; cpu++)
+		harness_set_idle(cpu, idle);
+}
+
+int harness_nr_idle(void)
+{
+	return poc_count_idle(&llc_sds, POC_MASK_CPUS);
+}
+
+int harness_nr_idle_cores(void)
+{
+	return poc_count_idle(&llc_sds, POC_MASK_CORES);
+}
+
+void harness_run_on(int cpu)
+{
+	shim_cpu = cpu;
+}
+
+int harness_select(int target, int *level)
+{
+	int cpu;
+
+	if (!level)
+		return select_idle_cpu_poc_wake(current, target, &llc_sds,
+						false, 0);
+
+	/* The timed wrapper notes the level (poc_sel_level) */
+	static_branch_inc(&sched_poc_tracing);
+	cpu = select_idle_cpu_poc_wake(current, target, &llc_sds, false, 0);
+	*level = cpu >= 0 ? __this_cpu_read(poc_sel_level) : POC_LVL_NONE;
+	static_branch_dec(&sched_poc_tracing);
+	return cpu;
+}
+
+#undef EM
+#undef EMe
+#define EM(a, b)	[a] = b,
+#define EMe(a, b)	[a] = b
+static const char *const level_names[] = { poc_levels };
+#undef EM
+#undef EMe
+
+const char *harness_level_name(int level)
+{
+	if (level < 0 || level >= (int)ARRAY_SIZE(level_names))
+		return "?";
+	return level_names[level];
+}
+
+void harness_set_claim(bool on)
+{
+	if (on)
+		static_branch_enable(&sched_poc_claim);
+	else
+		static_branch_disable(&sched_poc_claim);
+}
+
+void harness_set_l2_cluster_search(bool on)
+{
+	if (on)
+		static_branch_enable(&sched_poc_l2_cluster_search);
+	else
+		static_branch_disable(&sched_poc_l2_cluster_search);
+}
+
+struct cgroup_subsys_state *seq_css(struct seq_file *sf) { return &wakee_tg.css; }
+struct cgroup_subsys_state *of_css(struct kernfs_open_file *of) { return &wakee_tg.css; }
+
+int harness_set_placement(const char *name)
+{
+	char buf[32];
+	ssize_t ret;
+
+	snprintf(buf, sizeof(buf), "%s", name);
+	ret = poc_cgroup_placement_write(NULL, buf, strlen(buf), 0);
+	return ret < 0 ? (int)ret : 0;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Timed loops                                                        */
+/* ------------------------------------------------------------------ */
+
+static volatile int harness_sink;
+
+uint64_t harness_ticks(void)
+{
+	return get_cycles();
+}
+
+const char *harness_tick_unit(void)
+{
+#if defined(HARNESS_TSC)
+	return "cycles";
+#else
+	return "ns";
+#endif
+}
+
+uint64_t harness_time_select(int target, int n)
+{
+	int acc = 0, i;
+	u64 t0 = get_cycles();
+
+	for (i = 0; i < n; i++)
+		acc += select_idle_cpu_poc_wake(current, target, &llc_sds,
+						false, 0);
+	t0 = get_cycles() - t0;
+	harness_sink = acc;
+	return t0;
+}
+
+uint64_t harness_time_idle_update(int cpu, int n)
+{
+	bool idle = cpu_idle_state[cpu];
+	int saved = shim_cpu, i;
+	u64 t0;
+
+	shim_cpu = cpu;
+	t0 = get_cycles();
+	for (i = 0; i < n; i++)
+		__set_cpu_idle_state(cpu, (i & 1) ? idle : !idle);
+	t0 = get_cycles() - t0;
+	__set_cpu_idle_state(cpu, idle);
+	shim_cpu = saved;
+	return t0;
+}
+
+/* poc_select_rr() needs a compile-time word count to unroll */
+#define HARNESS_TIME_RR(N)						\
+	for (i = 0; i < n; i++) {					\
+		acc += poc_select_rr(mask, (N), &llc_sds, seed);	\
+		seed += POC_HASH_MULT;					\
+	}
+
+uint64_t harness_time_select_rr(int n)
+{
+	u64 mask[POC_MASK_WORDS_MAX];
+	unsigned int seed = 0;
+	int nr_words = llc_sds.poc_nr_words;
+	int acc = 0, i;
+	u64 t0;
+
+	poc_snapshot(mask, &llc_sds, POC_MASK_CPUS, NULL, POC_MASK_WORDS_MAX);
+	t0 = get_cycles();
+	if (nr_words == 1) {
+		HARNESS_TIME_RR(1)
+	} else if (nr_words == 2) {
+		HARNESS_TIME_RR(2)
+	} else if (nr_words <= 4) {
+		HARNESS_TIME_RR(4)
+	} else {
+		HARNESS_TIME_RR(8)
+	}
+	t0 = get_cycles() - t0;
+	harness_sink = acc;
+	return t0;
+}
+
+/* @nr must be a power of 2 */
+uint64_t harness_time_ctz(const uint64_t *words, int nr, int n)
+{
+	int acc = 0, i;
+	u64 t0 = get_cycles();
+
+	for (i = 0; i < n; i++)
+		acc += POC_CTZ64(words[i & (nr - 1)]);
+	t0 = get_cycles() - t0;
+	harness_sink = acc;
+	return t0;
+}
+
+/* @nr must be a power of 2; ranks[k] < popcount(words[k]) */
+uint64_t harness_time_ptselect(const uint64_t *words, const int *ranks,
+			       int nr, int n)
+{
+	int acc = 0, i;
+	u64 t0 = get_cycles();
+
+	for (i = 0; i < n; i++)
+		acc += POC_PTSELECT(words[i & (nr - 1)], ranks[i & (nr - 1)]);
+	t0 = get_cycles() - t0;
+	harness_sink = acc;
+	return t0;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Bit primitive tiers                                                */
+/* ------------------------------------------------------------------ */
+
+bool harness_set_tzcnt(bool on)
+{
+#ifdef POC_HW_TZCNT_RUNTIME
+	if (on && !boot_cpu_has(X86_FEATURE_BMI1))
+		return false;
+	if (on)
+		static_branch_enable(&poc_hw_tzcnt);
+	else
+		static_branch_disable(&poc_hw_tzcnt);
+	return true;
+#else
+	return false;
+#endif
+}
+
+bool harness_set_pdep(bool on)
+{
+#ifdef POC_HW_PDEP_RUNTIME
+	if (on && !boot_cpu_has(X86_FEATURE_BMI2))
+		return false;
+	if (on)
+		static_branch_enable(&poc_hw_pdep);
+	else
+		static_branch_disable(&poc_hw_pdep);
+	return true;
+#else
+	return false;
+#endif
+}
+
+const char *harness_ctz_name(void)
+{
+	return POC_CTZ64_NAME;
+}
+
+const char *harness_ptselect_name(void)
+{
+	return POC_PTSELECT_NAME;
+}
+
+int harness_ctz(uint64_t v)
+{
+	return POC_CTZ64(v);
+}
+
+int harness_ptselect(uint64_t v, int j)
+{
+	return POC_PTSELECT(v, j);
+}
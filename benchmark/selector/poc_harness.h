@@ -0,0 +1,85 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+/*
+ * POC Selector Harness: the selector core of kernel/sched/poc_selector.c
+ * built for userspace
+ *
+ * poc_harness.c compiles the unmodified selector (extracted from the
+ * patch) against kshim.h and drives it on one synthetic LLC.  Everything
+ * the kernel would do around it -- building the topology masks in
+ * sd_init(), the idle loop calling __set_cpu_idle_state(), the wakeup
+ * calling select_idle_cpu_poc_wake() -- is reproduced here, so callers
+ * only deal in CPU numbers.
+ *
+ * Single-threaded: the "current CPU" is a variable (harness_run_on()).
+ */
+#ifndef _POC_HARNESS_H
+#define _POC_HARNESS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define HARNESS_MAX_CPUS	512
+
+struct harness_topo {
+	int nr_cpus;	/* CPUs in the LLC, 1..HARNESS_MAX_CPUS */
+	int smt;	/* threads per core: adjacent CPU IDs */
+	int cluster;	/* CPUs per L2 cluster, multiple of smt; 0 = none */
+};
+
+/* Build the LLC, all CPUs busy.  Returns 0 or -EINVAL. */
+int harness_init(const struct harness_topo *topo);
+const struct harness_topo *harness_topo(void);
+int harness_nr_words(void);
+
+/* Occupancy, through the kernel's own idle-mask update */
+void harness_set_idle(int cpu, bool idle);
+bool harness_cpu_idle(int cpu);
+/* A wakee is queued on @cpu but not running yet (rq->ttwu_pending) */
+void harness_set_queued(int cpu, bool queued);
+void harness_fill(bool idle);
+int harness_nr_idle(void);
+int harness_nr_idle_cores(void);
+
+/* Simulated CPU the next selection runs on (per-CPU RR seed) */
+void harness_run_on(int cpu);
+
+/*
+ * One select_idle_cpu_poc_wake() for an unrestricted task.  With @level,
+ * the timed wrapper runs and reports the POC_LVL_* that picked.
+ * Returns the CPU, or -1 when the kernel would fall back to CFS.
+ */
+int harness_select(int target, int *level);
+const char *harness_level_name(int level);
+
+/* Runtime knobs of the selector (kernel.sched_poc_*) */
+void harness_set_claim(bool on);
+void harness_set_l2_cluster_search(bool on);
+/* "spread", "compact" or "cluster-pack"; 0 or -EINVAL */
+int harness_set_placement(const char *name);
+
+/*
+ * Timed loops, run inside the selector's translation unit so the
+ * per-call overhead is the kernel's.  Return the elapsed ticks of @n
+ * operations (cycles on x86-64, nanoseconds elsewhere).
+ */
+uint64_t harness_ticks(void);
+const char *harness_tick_unit(void);
+uint64_t harness_time_select(int target, int n);
+uint64_t harness_time_idle_update(int cpu, int n);
+uint64_t harness_time_select_rr(int n);
+uint64_t harness_time_ctz(const uint64_t *words, int nr, int n);
+uint64_t harness_time_ptselect(const uint64_t *words, const int *ranks,
+			       int nr, int n);
+
+/*
+ * Bit primitive tiers.  The hardware tiers are switched at run time
+ * like sched_poc_hw_init() does; false if this CPU or build cannot.
+ */
+bool harness_set_tzcnt(bool on);
+bool harness_set_pdep(bool on);
+const char *harness_ctz_name(void);
+const char *harness_ptselect_name(void);
+int harness_ctz(uint64_t v);
+int harness_ptselect(uint64_t v, int j);
+
+#endif /* _POC_HARNESS_H */
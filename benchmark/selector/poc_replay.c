@@ -0,0 +1,642 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * POC Selector Replay: placement quality of the selector on a recorded trace
+ *
+ * Replays the sched_switch / sched_wakeup stream of one LLC, recorded on
+ * a real host (record.sh), through the selector core of
+ * kernel/sched/poc_selector.c (see poc_harness.h) once per policy, and
+ * counts how often each policy made a poor pick:
+ *
+ *   busy_sib  picked CPU has a busy SMT sibling      (avoid: an idle core existed)
+ *   xcluster  picked CPU outside the target's cluster (avoid: the cluster had one)
+ *   collide   picked CPU was already handed to another wakee still in flight
+ *   match     picked the CPU the recording kernel picked (sched_wakeup target_cpu)
+ *
+ * Occupancy follows the trace: a CPU is idle while it runs the idle task
+ * (pid 0), and is assumed idle until its first event.  The wakee's target
+ * is the CPU it last ran on, else the waking CPU.  A simulated pick is
+ * "in flight" for --window microseconds or until the trace next switches
+ * on that CPU; a second pick of it meanwhile is a collision -- what
+ * sched_poc_claim is there to prevent.
+ *
+ * Usage:
+ *   ./poc_replay -T host.topo [-L LLC] [-P POLICIES] [-w US] host.trace
+ *   ./poc_replay -c CPUS -s SMT -l CLUSTER host.trace
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <ctype.h>
+#include "poc_harness.h"
+
+/* ------------------------------------------------------------------ */
+/*  Constants                                                          */
+/* ------------------------------------------------------------------ */
+
+#define MAX_TRACE_CPUS      8192
+#define MAX_LEVELS          16
+#define DEFAULT_WINDOW_US   50
+
+enum { EV_SWITCH, EV_WAKEUP };
+
+struct event {
+	uint64_t ts;		/* ns */
+	int32_t  pid;		/* switch: next_pid; wakeup: wakee */
+	int16_t  cpu;		/* LLC index of the CPU the event ran on, -1 = outside */
+	int16_t  target;	/* wakeup: LLC index of target_cpu, -1 = outside */
+	uint8_t  type;
+};
+
+/* ------------------------------------------------------------------ */
+/*  Policies                                                           */
+/* ------------------------------------------------------------------ */
+
+struct policy {
+	const char *name;
+	const char *desc;
+	bool        l2_cluster_search;
+	bool        claim;
+	const char *placement;	/* cpu.poc_placement */
+};
+
+static const struct policy policies[] = {
+	{ "default",      "kernel defaults",                 true,  false, "spread" },
+	{ "no_l2",        "sched_poc_l2_cluster_search=0",   false, false, "spread" },
+	{ "claim",        "sched_poc_claim=1",               true,  true,  "spread" },
+	{ "compact",      "cpu.poc_placement=compact",       true,  false, "compact" },
+	{ "cluster_pack", "cpu.poc_placement=cluster-pack",  true,  false, "cluster-pack" },
+};
+#define NR_POLICIES (int)(sizeof(policies) / sizeof(policies[0]))
+
+static const struct policy *policy_find(const char *name)
+{
+	for (int i = 0; i < NR_POLICIES; i++)
+		if (!strcmp(policies[i].name, name))
+			return &policies[i];
+	return NULL;
+}
+
+static void policy_apply(const struct policy *pol)
+{
+	harness_set_l2_cluster_search(pol->l2_cluster_search);
+	harness_set_claim(pol->claim);
+	harness_set_placement(pol->placement);
+}
+
+/* ------------------------------------------------------------------ */
+/*  Topology                                                           */
+/* ------------------------------------------------------------------ */
+
+/* Trace CPU -> LLC index (harness CPU), -1 when outside the LLC */
+static int cpu_map[MAX_TRACE_CPUS];
+
+struct topo_row {
+	int cpu, llc, cluster, core;
+};
+
+static int cmp_row(const void *a, const void *b)
+{
+	const struct topo_row *ra = a, *rb = b;
+
+	if (ra->cluster != rb->cluster)
+		return ra->cluster - rb->cluster;
+	if (ra->core != rb->core)
+		return ra->core - rb->core;
+	return ra->cpu - rb->cpu;
+}
+
+static bool is_pow2(int v)
+{
+	return v > 0 && !(v & (v - 1));
+}
+
+/* Identity map onto -c/-s/-l */
+static void topo_identity(struct harness_topo *t)
+{
+	for (int i = 0; i < MAX_TRACE_CPUS; i++)
+		cpu_map[i] = i < t->nr_cpus ? i : -1;
+}
+
+/*
+ * record.sh topology file, one "cpu llc cluster core" line per CPU.
+ * The CPUs of @llc (-1: the first CPU's) are renumbered so that SMT
+ * siblings and clusters are contiguous, as the harness lays them out.
+ */
+static int topo_load(const char *path, int llc, struct harness_topo *t)
+{
+	static struct topo_row rows[MAX_TRACE_CPUS];
+	struct topo_row r;
+	char line[256];
+	int n = 0;
+	FILE *f = fopen(path, "r");
+
+	if (!f) {
+		perror(path);
+		return -1;
+	}
+	while (fgets(line, sizeof(line), f)) {
+		if (line[0] == '#' ||
+		    sscanf(line, "%d %d %d %d", &r.cpu, &r.llc, &r.cluster,
+			   &r.core) != 4)
+			continue;
+		if (r.cpu < 0 || r.cpu >= MAX_TRACE_CPUS)
+			continue;
+		if (llc < 0)
+			llc = r.llc;
+		if (r.llc == llc && n < HARNESS_MAX_CPUS)
+			rows[n++] = r;
+	}
+	fclose(f);
+	if (!n) {
+		fprintf(stderr, "%s: no CPUs in LLC %d\n", path, llc);
+		return -1;
+	}
+
+	qsort(rows, n, sizeof(rows[0]), cmp_row);
+	for (int i = 0; i < MAX_TRACE_CPUS; i++)
+		cpu_map[i] = -1;
+	for (int i = 0; i < n; i++)
+		cpu_map[rows[i].cpu] = i;
+
+	/* Group sizes must be uniform, the harness has one shape per LLC */
+	int smt = 0, cls = 0;
+	for (int i = 0, run_core = 0, run_cls = 0; i <= n; i++) {
+		bool new_core = i == n || (i && rows[i].core != rows[i - 1].core);
+		bool new_cls = i == n || (i && rows[i].cluster != rows[i - 1].cluster);
+
+		if (new_core) {
+			if (smt && run_core != smt)
+				goto uneven;
+			smt = run_core;
+			run_core = 0;
+		}
+		if (new_cls) {
+			if (cls && run_cls != cls)
+				goto uneven;
+			cls = run_cls;
+			run_cls = 0;
+		}
+		run_core++;
+		run_cls++;
+	}
+
+	t->nr_cpus = n;
+	t->smt = smt;
+	t->cluster = cls;
+	if (cls == smt || cls == n)
+		t->cluster = 0;
+	else if (!is_pow2(cls) || cls > 64) {
+		fprintf(stderr, "%s: %d-CPU clusters unsupported, replaying without\n",
+			path, cls);
+		t->cluster = 0;
+	}
+	return 0;
+
+uneven:
+	fprintf(stderr, "%s: LLC %d has uneven cores or clusters\n", path, llc);
+	return -1;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Trace parsing                                                      */
+/* ------------------------------------------------------------------ */
+
+static struct event *events;
+static size_t nr_events, cap_events;
+static size_t nr_lines_skipped;
+static int max_pid;
+
+static void event_add(const struct event *ev)
+{
+	if (nr_events == cap_events) {
+		cap_events = cap_events ? cap_events * 2 : 1 << 16;
+		events = realloc(events, cap_events * sizeof(*events));
+		if (!events) {
+			perror("realloc");
+			exit(1);
+		}
+	}
+	events[nr_events++] = *ev;
+	if (ev->pid > max_pid)
+		max_pid = ev->pid;
+}
+
+/* Value of " key=" in @s, or -1 */
+static long field(const char *s, const char *key)
+{
+	size_t len = strlen(key);
+
+	for (const char *p = strstr(s, key); p; p = strstr(p + 1, key))
+		if (p == s || p[-1] == ' ')
+			return strtol(p + len, NULL, 10);
+	return -1;
+}
+
+/*
+ * One line of ftrace text output (trace-cmd report, tracefs "trace") or
+ * perf script:
+ *   <comm>-<pid> [cpu] <flags> <ts>: sched_switch: ... next_pid=N ...
+ *   <comm> <pid> [cpu] <ts>: sched:sched_wakeup: ... pid=N ... target_cpu=M
+ */
+static bool parse_line(const char *line, struct event *ev)
+{
+	const char *name, *args, *br = NULL, *p;
+	long cpu, pid, target = -1;
+	double ts = -1;
+
+	if ((name = strstr(line, "sched_switch: "))) {
+		ev->type = EV_SWITCH;
+		args = name + strlen("sched_switch: ");
+		pid = field(args, "next_pid=");
+	} else if ((name = strstr(line, "sched_wakeup: ")) ||
+		   (name = strstr(line, "sched_wakeup_new: "))) {
+		ev->type = EV_WAKEUP;
+		args = strchr(name, ' ') + 1;
+		pid = field(args, "pid=");
+		target = field(args, "target_cpu=");
+		if (target < 0)
+			return false;
+	} else {
+		return false;
+	}
+
+	/* Last "[cpu]" before the event name; comm may hold brackets */
+	for (p = line; (p = strchr(p, '[')) && p < name; p++)
+		if (isdigit((unsigned char)p[1]))
+			br = p;
+	if (!br || pid < 0)
+		return false;
+	cpu = strtol(br + 1, NULL, 10);
+
+	/* Timestamp: the "<secs>.<frac>:" token between [cpu] and the name */
+	for (p = strchr(br, ']'); p && p < name; p++) {
+		char *end;
+		double v;
+
+		if (!isdigit((unsigned char)*p) || !isspace((unsigned char)p[-1]))
+			continue;
+		v = strtod(p, &end);
+		if (*end == ':' && memchr(p, '.', end - p)) {
+			ts = v;
+			break;
+		}
+	}
+	if (ts < 0 || cpu >= MAX_TRACE_CPUS ||
+	    (target >= 0 && target >= MAX_TRACE_CPUS))
+		return false;
+
+	ev->ts = (uint64_t)(ts * 1e9);
+	ev->pid = (int32_t)pid;
+	ev->cpu = (int16_t)cpu_map[cpu];
+	ev->target = target >= 0 ? (int16_t)cpu_map[target] : -1;
+	return true;
+}
+
+static int trace_load(const char *path)
+{
+	FILE *f = strcmp(path, "-") ? fopen(path, "r") : stdin;
+	char *line = NULL;
+	size_t len = 0;
+	struct event ev;
+
+	if (!f) {
+		perror(path);
+		return -1;
+	}
+	while (getline(&line, &len, f) > 0) {
+		if (parse_line(line, &ev))
+			event_add(&ev);
+		else
+			nr_lines_skipped++;
+	}
+	free(line);
+	if (f != stdin)
+		fclose(f);
+	return nr_events ? 0 : -1;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Replay                                                             */
+/* ------------------------------------------------------------------ */
+
+struct replay_stats {
+	uint64_t wakeups;	/* replayed: wakee's target inside the LLC */
+	uint64_t fallthru;
+	uint64_t busy_sib, busy_sib_avoid;
+	uint64_t xcluster, xcluster_avoid;
+	uint64_t collide;
+	uint64_t matched, comparable;
+	uint64_t level[MAX_LEVELS];
+};
+
+static int window_us = DEFAULT_WINDOW_US;
+
+/* In-flight picks: expiry is monotonic, so a FIFO is enough */
+static uint64_t inflight_until[HARNESS_MAX_CPUS];
+static struct { uint64_t until; int cpu; } *fifo;
+static size_t fifo_head, fifo_tail, fifo_cap;
+
+static void inflight_expire(uint64_t now)
+{
+	while (fifo_head != fifo_tail && fifo[fifo_head].until <= now) {
+		int cpu = fifo[fifo_head].cpu;
+
+		fifo_head = (fifo_head + 1) % fifo_cap;
+		if (inflight_until[cpu] && inflight_until[cpu] <= now) {
+			inflight_until[cpu] = 0;
+			harness_set_queued(cpu, false);
+			/* The wakee never showed up: put back what claim took */
+			if (harness_cpu_idle(cpu))
+				harness_set_idle(cpu, true);
+		}
+	}
+}
+
+static void inflight_add(int cpu, uint64_t until)
+{
+	if ((fifo_tail + 1) % fifo_cap == fifo_head) {
+		fprintf(stderr, "in-flight queue overflow, lower --window\n");
+		exit(1);
+	}
+	fifo[fifo_tail].until = until;
+	fifo[fifo_tail].cpu = cpu;
+	fifo_tail = (fifo_tail + 1) % fifo_cap;
+	inflight_until[cpu] = until;
+	harness_set_queued(cpu, true);
+}
+
+static bool cpu_free(int cpu)
+{
+	return harness_cpu_idle(cpu) && !inflight_until[cpu];
+}
+
+static int group_first(int cpu, int size)
+{
+	return size ? cpu - cpu % size : cpu;
+}
+
+static void replay(const struct policy *pol, struct replay_stats *st)
+{
+	const struct harness_topo *t = harness_topo();
+	int *task_cpu = malloc((max_pid + 1) * sizeof(int));
+
+	if (!task_cpu) {
+		perror("malloc");
+		exit(1);
+	}
+	for (int i = 0; i <= max_pid; i++)
+		task_cpu[i] = -1;
+	memset(st, 0, sizeof(*st));
+	memset(inflight_until, 0, sizeof(inflight_until));
+	fifo_head = fifo_tail = 0;
+
+	harness_init(t);
+	harness_fill(true);
+	policy_apply(pol);
+
+	for (size_t i = 0; i < nr_events; i++) {
+		const struct event *ev = &events[i];
+		int target, cpu, level;
+
+		inflight_expire(ev->ts);
+
+		if (ev->type == EV_SWITCH) {
+			if (ev->cpu < 0)
+				continue;
+			inflight_until[ev->cpu] = 0;
+			harness_set_queued(ev->cpu, false);
+			harness_set_idle(ev->cpu, ev->pid == 0);
+			if (ev->pid)
+				task_cpu[ev->pid] = ev->cpu;
+			continue;
+		}
+
+		target = task_cpu[ev->pid] >= 0 ? task_cpu[ev->pid] : ev->cpu;
+		if (target < 0)
+			continue;
+		st->wakeups++;
+
+		bool idle_core = harness_nr_idle_cores() > 0;
+		bool cls_free = false;
+		if (t->cluster)
+			for (int c = group_first(target, t->cluster);
+			     c < group_first(target, t->cluster) + t->cluster; c++)
+				cls_free |= cpu_free(c);
+
+		harness_run_on(ev->cpu >= 0 ? ev->cpu : target);
+		cpu = harness_select(target, &level);
+		if (level >= 0 && level < MAX_LEVELS)
+			st->level[level]++;
+		if (ev->target >= 0) {
+			st->comparable++;
+			st->matched += cpu == ev->target;
+		}
+		if (cpu < 0) {
+			st->fallthru++;
+			continue;
+		}
+
+		if (t->smt > 1) {
+			bool busy = false;
+
+			for (int s = group_first(cpu, t->smt);
+			     s < group_first(cpu, t->smt) + t->smt; s++)
+				busy |= s != cpu && !cpu_free(s);
+			st->busy_sib += busy;
+			st->busy_sib_avoid += busy && idle_core;
+		}
+		if (t->cluster &&
+		    group_first(cpu, t->cluster) != group_first(target, t->cluster)) {
+			st->xcluster++;
+			st->xcluster_avoid += cls_free;
+		}
+		if (inflight_until[cpu])
+			st->collide++;
+		inflight_add(cpu, ev->ts + (uint64_t)window_us * 1000);
+	}
+	free(task_cpu);
+}
+
+/* ------------------------------------------------------------------ */
+/*  Report                                                             */
+/* ------------------------------------------------------------------ */
+
+static double pct(uint64_t n, uint64_t d)
+{
+	return d ? 100.0 * n / d : 0.0;
+}
+
+static void print_header(void)
+{
+	printf("  %-13s %9s %9s %9s %8s %9s %8s %8s %8s\n",
+	       "policy", "wakeups", "fallthru", "busy_sib", "(avoid)",
+	       "xcluster", "(avoid)", "collide", "match");
+}
+
+static void print_row(const struct policy *pol, const struct replay_stats *st)
+{
+	printf("  %-13s %9llu %8.2f%% %8.2f%% %7.2f%% %8.2f%% %7.2f%% %7.2f%% %7.2f%%\n",
+	       pol->name, (unsigned long long)st->wakeups,
+	       pct(st->fallthru, st->wakeups),
+	       pct(st->busy_sib, st->wakeups),
+	       pct(st->busy_sib_avoid, st->wakeups),
+	       pct(st->xcluster, st->wakeups),
+	       pct(st->xcluster_avoid, st->wakeups),
+	       pct(st->collide, st->wakeups),
+	       pct(st->matched, st->comparable));
+}
+
+static void print_levels(const struct policy **sel, int nr_sel,
+			 const struct replay_stats *st)
+{
+	int nr_levels = 0;
+
+	while (nr_levels < MAX_LEVELS &&
+	       strcmp(harness_level_name(nr_levels), "?"))
+		nr_levels++;
+
+	printf("\n--- Picking level (%% of wakeups) ---\n");
+	printf("  %-13s", "policy");
+	for (int l = 1; l <= nr_levels; l++)	/* POC_LVL_NONE last */
+		printf(" %6s", harness_level_name(l % nr_levels));
+	printf("\n");
+	for (int i = 0; i < nr_sel; i++) {
+		printf("  %-13s", sel[i]->name);
+		for (int l = 1; l <= nr_levels; l++)
+			printf(" %6.2f", pct(st[i].level[l % nr_levels],
+					     st[i].wakeups));
+		printf("\n");
+	}
+}
+
+/* ------------------------------------------------------------------ */
+/*  Main                                                               */
+/* ------------------------------------------------------------------ */
+
+static void usage(const char *prog)
+{
+	fprintf(stderr,
+		"Usage: %s [OPTIONS] TRACE\n"
+		"  TRACE                                   sched_switch/sched_wakeup text (ftrace or perf script), - for stdin\n"
+		"  -T, --topology <FILE>                   CPU topology from record.sh (\"cpu llc cluster core\" lines)\n"
+		"  -L, --llc <ID>                          LLC of the topology file to replay (default: CPU 0's)\n"
+		"  -c, --cpus <N>                          Without -T: CPUs 0..N-1 form the LLC\n"
+		"  -s, --smt <N>                           Without -T: threads per core (default: 1)\n"
+		"  -l, --cluster <N>                       Without -T: CPUs per L2 cluster, 0 = none (default: 0)\n"
+		"  -P, --policies <LIST>                   Comma-separated policies (default: all)\n"
+		"  -w, --window <US>                       In-flight time of a pick (default: %d)\n"
+		"  -h, --help                              Show this help\n"
+		"\nPolicies:\n",
+		prog, DEFAULT_WINDOW_US);
+	for (int i = 0; i < NR_POLICIES; i++)
+		fprintf(stderr, "  %-13s %s\n", policies[i].name, policies[i].desc);
+}
+
+int main(int argc, char *argv[])
+{
+	struct harness_topo topo = { .nr_cpus = 0, .smt = 1, .cluster = 0 };
+	const struct policy *sel[NR_POLICIES];
+	const char *topo_path = NULL;
+	char *policy_list = NULL;
+	int nr_sel = 0, llc = -1;
+
+	static struct option long_opts[] = {
+		{"topology", required_argument, NULL, 'T'},
+		{"llc",      required_argument, NULL, 'L'},
+		{"cpus",     required_argument, NULL, 'c'},
+		{"smt",      required_argument, NULL, 's'},
+		{"cluster",  required_argument, NULL, 'l'},
+		{"policies", required_argument, NULL, 'P'},
+		{"window",   required_argument, NULL, 'w'},
+		{"help",     no_argument,       NULL, 'h'},
+		{NULL, 0, NULL, 0}
+	};
+
+	int opt;
+	while ((opt = getopt_long(argc, argv, "T:L:c:s:l:P:w:h", long_opts,
+				  NULL)) != -1) {
+		switch (opt) {
+		case 'T': topo_path = optarg; break;
+		case 'L': llc = atoi(optarg); break;
+		case 'c': topo.nr_cpus = atoi(optarg); break;
+		case 's': topo.smt = atoi(optarg); break;
+		case 'l': topo.cluster = atoi(optarg); break;
+		case 'P': policy_list = optarg; break;
+		case 'w': window_us = atoi(optarg); break;
+		case 'h': usage(argv[0]); return 0;
+		default:  usage(argv[0]); return 1;
+		}
+	}
+	if (optind != argc - 1 || window_us < 0 ||
+	    (!topo_path && topo.nr_cpus <= 0)) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	if (policy_list) {
+		for (char *tok = strtok(policy_list, ","); tok;
+		     tok = strtok(NULL, ",")) {
+			if (nr_sel == NR_POLICIES || !(sel[nr_sel] = policy_find(tok))) {
+				fprintf(stderr, "unknown policy: %s\n", tok);
+				usage(argv[0]);
+				return 1;
+			}
+			nr_sel++;
+		}
+	} else {
+		for (nr_sel = 0; nr_sel < NR_POLICIES; nr_sel++)
+			sel[nr_sel] = &policies[nr_sel];
+	}
+
+	if (topo_path) {
+		if (topo_load(topo_path, llc, &topo) < 0)
+			return 1;
+	} else {
+		topo_identity(&topo);
+	}
+	if (harness_init(&topo) < 0) {
+		fprintf(stderr, "unsupported LLC: %d CPUs, SMT%d, cluster %d\n",
+			topo.nr_cpus, topo.smt, topo.cluster);
+		return 1;
+	}
+	if (trace_load(argv[optind]) < 0) {
+		fprintf(stderr, "%s: no sched_switch/sched_wakeup events\n",
+			argv[optind]);
+		return 1;
+	}
+
+	/* Every pick can be in flight at once, plus one */
+	fifo_cap = nr_events + 1;
+	fifo = malloc(fifo_cap * sizeof(*fifo));
+	if (!fifo) {
+		perror("malloc");
+		return 1;
+	}
+
+	printf("=== POC Selector Replay ===\n");
+	printf("Trace: %s (%zu events, %zu other lines)\n",
+	       argv[optind], nr_events, nr_lines_skipped);
+	printf("LLC:   %d CPUs, SMT%d, cluster %d\n",
+	       topo.nr_cpus, topo.smt, topo.cluster);
+	printf("HW:    CTZ=%s  PTSelect=%s  window %d us\n",
+	       harness_ctz_name(), harness_ptselect_name(), window_us);
+
+	struct replay_stats st[NR_POLICIES];
+
+	printf("\n");
+	print_header();
+	for (int i = 0; i < nr_sel; i++) {
+		replay(sel[i], &st[i]);
+		print_row(sel[i], &st[i]);
+	}
+	print_levels(sel, nr_sel, st);
+
+	free(fifo);
+	free(events);
+	printf("\nDone.\n");
+	return 0;
+}
@@ -0,0 +1,493 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * POC Selector Harness: per-level cost of the selector, in userspace
+ *
+ * Runs the selector core of kernel/sched/poc_selector.c (see
+ * poc_harness.h) on a synthetic LLC and times each level of the
+ * hierarchy -- sticky, L2 core, LLC core, SMT sibling, L2 SMT, LLC RR,
+ * saturated -- by arranging the idle masks so that exactly that level
+ * picks, then the building blocks: the idle-mask update, poc_select_rr()
+ * and the CTZ / PTSelect tiers.  No patched kernel, no root.
+ *
+ * Usage:
+ *   ./poc_selbench [-c CPUS] [-s SMT] [-l CLUSTER] [-o OCCUPANCY]
+ *                  [-i ITERS] [-r ROUNDS] [-p PIN] [--all-tiers]
+ *
+ * poc_selbench_sw is the same program built with the portable tiers
+ * (De Bruijn CTZ, PTSelect loop); compare its ctz / ptselect rows with
+ * this one's.
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <getopt.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "poc_harness.h"
+
+/* ------------------------------------------------------------------ */
+/*  Constants                                                          */
+/* ------------------------------------------------------------------ */
+
+#define DEFAULT_CPUS        64
+#define DEFAULT_SMT         2
+#define DEFAULT_CLUSTER     8
+#define DEFAULT_OCCUPANCY   50
+#define DEFAULT_ITERATIONS  200000
+#define DEFAULT_ROUNDS      15
+#define PRIM_WORDS          1024	/* power of 2, see harness_time_ctz() */
+
+/* ------------------------------------------------------------------ */
+/*  Utility: statistics                                                */
+/* ------------------------------------------------------------------ */
+
+struct op_result {
+	double min;
+	double p50;
+	double mean;
+};
+
+static int cmp_double(const void *a, const void *b)
+{
+	double va = *(const double *)a;
+	double vb = *(const double *)b;
+	return (va > vb) - (va < vb);
+}
+
+static struct op_result op_compute(double *per_op, int n)
+{
+	struct op_result r = {0};
+	double sum = 0;
+
+	qsort(per_op, n, sizeof(double), cmp_double);
+	for (int i = 0; i < n; i++)
+		sum += per_op[i];
+	r.min = per_op[0];
+	r.p50 = per_op[n / 2];
+	r.mean = sum / n;
+	return r;
+}
+
+static void op_print(const char *label, const char *detail,
+		     struct op_result *r)
+{
+	printf("  %-12s %-24s %9.1f %9.1f %9.1f\n",
+	       label, detail, r->min, r->p50, r->mean);
+}
+
+static void op_header(void)
+{
+	printf("  %-12s %-24s %9s %9s %9s   (%s/op)\n",
+	       "", "", "min", "p50", "mean", harness_tick_unit());
+}
+
+/* ------------------------------------------------------------------ */
+/*  Level scenarios                                                    */
+/* ------------------------------------------------------------------ */
+
+static int opt_occupancy = DEFAULT_OCCUPANCY;
+
+/* First CPU of @cpu's core / cluster, and the group sizes */
+static int core_first(int cpu)    { return cpu - cpu % harness_topo()->smt; }
+static int cluster_size(void)
+{
+	const struct harness_topo *t = harness_topo();
+	return t->cluster > t->smt ? t->cluster : t->smt;
+}
+static int cluster_first(int cpu) { return cpu - cpu % cluster_size(); }
+
+/*
+ * Busy pattern outside the target's cluster: every core is busy except
+ * one in every 100 / (100 - occupancy), so roughly 100 - occupancy
+ * percent of the remaining cores are available.
+ */
+static bool core_left_idle(int core_idx)
+{
+	int stride = opt_occupancy >= 100 ? 0 :
+		     100 / (100 - opt_occupancy);
+
+	return stride && core_idx % stride == 0;
+}
+
+/* Idle whole cores outside target's cluster (Level 3) */
+static void setup_llc_core(int target)
+{
+	const struct harness_topo *t = harness_topo();
+
+	harness_fill(false);
+	for (int c = 0, idx = 0; c < t->nr_cpus; c += t->smt, idx++) {
+		if (cluster_first(c) == cluster_first(target) ||
+		    !core_left_idle(idx))
+			continue;
+		for (int i = 0; i < t->smt; i++)
+			harness_set_idle(c + i, true);
+	}
+}
+
+/* One idle thread per core outside target's cluster (Level 6) */
+static void setup_llc_cpu(int target)
+{
+	const struct harness_topo *t = harness_topo();
+
+	harness_fill(false);
+	for (int c = 0, idx = 0; c < t->nr_cpus; c += t->smt, idx++)
+		if (cluster_first(c) != cluster_first(target) &&
+		    core_left_idle(idx))
+			harness_set_idle(c + t->smt - 1, true);
+}
+
+static void setup_sticky(int target)
+{
+	harness_fill(true);
+}
+
+/* Another core of target's cluster is idle (Level 2) */
+static void setup_l2_core(int target)
+{
+	const struct harness_topo *t = harness_topo();
+	int other = cluster_first(target) +
+		    (core_first(target) == cluster_first(target) ? t->smt : 0);
+
+	setup_llc_core(target);
+	for (int i = 0; i < t->smt; i++)
+		harness_set_idle(core_first(other) + i, true);
+}
+
+/* No idle core, target's sibling idle (Level 4) */
+static void setup_smt_tgt(int target)
+{
+	const struct harness_topo *t = harness_topo();
+
+	setup_llc_cpu(target);
+	for (int c = cluster_first(target);
+	     c < cluster_first(target) + cluster_size(); c++)
+		harness_set_idle(c, false);
+	harness_set_idle(core_first(target) + (target % t->smt ? 0 : 1), true);
+}
+
+/* No idle core, target's core busy, a thread in the cluster idle (Level 5) */
+static void setup_l2_smt(int target)
+{
+	const struct harness_topo *t = harness_topo();
+	int other = cluster_first(target) +
+		    (core_first(target) == cluster_first(target) ? t->smt : 0);
+
+	setup_llc_cpu(target);
+	harness_set_idle(core_first(other) + t->smt - 1, true);
+}
+
+static void setup_saturated(int target)
+{
+	harness_fill(false);
+}
+
+struct scenario {
+	const char *name;
+	void (*setup)(int target);
+	const char *expect;	/* harness_level_name(): "1".."7", "none" */
+};
+
+static const struct scenario scenarios[] = {
+	{ "sticky",    setup_sticky,    "1" },
+	{ "l2_core",   setup_l2_core,   "2" },
+	{ "llc_core",  setup_llc_core,  "3" },
+	{ "smt_tgt",   setup_smt_tgt,   "4" },
+	{ "l2_smt",    setup_l2_smt,    "5" },
+	{ "llc_cpu",   setup_llc_cpu,   "6" },
+	{ "saturated", setup_saturated, "none" },
+};
+
+/* ------------------------------------------------------------------ */
+/*  Runners                                                            */
+/* ------------------------------------------------------------------ */
+
+struct bench_config {
+	int target;
+	int iterations;
+	int rounds;
+};
+
+typedef uint64_t (*timed_fn)(void *arg, int n);
+
+static struct op_result run_timed(struct bench_config *cfg, timed_fn fn,
+				  void *arg)
+{
+	double per_op[cfg->rounds];
+
+	fn(arg, cfg->iterations / 10);	/* warm caches and predictors */
+	for (int r = 0; r < cfg->rounds; r++)
+		per_op[r] = (double)fn(arg, cfg->iterations) / cfg->iterations;
+	return op_compute(per_op, cfg->rounds);
+}
+
+static uint64_t timed_select(void *arg, int n)
+{
+	return harness_time_select(*(int *)arg, n);
+}
+
+static uint64_t timed_idle_update(void *arg, int n)
+{
+	return harness_time_idle_update(*(int *)arg, n);
+}
+
+static uint64_t timed_select_rr(void *arg, int n)
+{
+	return harness_time_select_rr(n);
+}
+
+struct prim_set {
+	uint64_t words[PRIM_WORDS];
+	int      ranks[PRIM_WORDS];
+};
+
+static uint64_t timed_ctz(void *arg, int n)
+{
+	struct prim_set *ps = arg;
+	return harness_time_ctz(ps->words, PRIM_WORDS, n);
+}
+
+static uint64_t timed_ptselect(void *arg, int n)
+{
+	struct prim_set *ps = arg;
+	return harness_time_ptselect(ps->words, ps->ranks, PRIM_WORDS, n);
+}
+
+/* xorshift64*: reproducible words for the primitive rows */
+static uint64_t prim_rand(uint64_t *s)
+{
+	*s ^= *s >> 12;
+	*s ^= *s << 25;
+	*s ^= *s >> 27;
+	return *s * 0x2545F4914F6CDD1DULL;
+}
+
+static void prim_fill(struct prim_set *ps)
+{
+	uint64_t s = 0x9E3779B97F4A7C15ULL;
+
+	for (int i = 0; i < PRIM_WORDS; i++) {
+		uint64_t w = prim_rand(&s) & prim_rand(&s);	/* ~16 bits set */
+
+		if (!w)
+			w = 1;
+		ps->words[i] = w;
+		ps->ranks[i] = (int)(prim_rand(&s) % __builtin_popcountll(w));
+	}
+}
+
+static void run_levels(struct bench_config *cfg)
+{
+	const struct harness_topo *t = harness_topo();
+	int target = cfg->target;
+
+	/* Occupancy differs per row: each shows its own idle count */
+	printf("\n--- Levels (target CPU %d) ---\n", target);
+	op_header();
+
+	for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+		const struct scenario *sc = &scenarios[i];
+		int level, cpu;
+		char detail[32];
+
+		sc->setup(target);
+		cpu = harness_select(target, &level);
+		if (strcmp(harness_level_name(level), sc->expect)) {
+			printf("  %-12s skipped: level %s picks on SMT%d/cluster %d\n",
+			       sc->name, harness_level_name(level), t->smt,
+			       t->cluster);
+			continue;
+		}
+		snprintf(detail, sizeof(detail), "%s%s -> %d (%d/%d idle)",
+			 level ? "L" : "", harness_level_name(level), cpu,
+			 harness_nr_idle(), t->nr_cpus);
+		struct op_result r = run_timed(cfg, timed_select, &target);
+		op_print(sc->name, detail, &r);
+	}
+}
+
+static void run_blocks(struct bench_config *cfg)
+{
+	static struct prim_set ps;
+	int target = cfg->target;
+	struct op_result r;
+
+	printf("\n--- Building blocks ---\n");
+	op_header();
+
+	setup_llc_cpu(target);
+	r = run_timed(cfg, timed_idle_update, &target);
+	op_print("idle_update", "busy<->idle", &r);
+	r = run_timed(cfg, timed_select_rr, NULL);
+	op_print("select_rr", "llc_cpu mask", &r);
+
+	prim_fill(&ps);
+	bool tz_rt = harness_set_tzcnt(true);
+	for (int pass = 0; pass < (tz_rt ? 2 : 1); pass++) {
+		if (tz_rt)
+			harness_set_tzcnt(pass == 0);
+		r = run_timed(cfg, timed_ctz, &ps);
+		op_print("ctz", harness_ctz_name(), &r);
+	}
+	bool pd_rt = harness_set_pdep(true);
+	for (int pass = 0; pass < (pd_rt ? 2 : 1); pass++) {
+		if (pd_rt)
+			harness_set_pdep(pass == 0);
+		r = run_timed(cfg, timed_ptselect, &ps);
+		op_print("ptselect", harness_ptselect_name(), &r);
+	}
+}
+
+/* Self-check of the primitives against the compiler builtins */
+static int check_primitives(void)
+{
+	static struct prim_set ps;
+
+	prim_fill(&ps);
+	for (int i = 0; i < PRIM_WORDS; i++) {
+		uint64_t w = ps.words[i];
+		int j = ps.ranks[i], pos = __builtin_ctzll(w);
+
+		for (int k = 0; k < j; k++) {
+			w &= w - 1;
+			pos = __builtin_ctzll(w);
+		}
+		if (harness_ctz(ps.words[i]) != __builtin_ctzll(ps.words[i]) ||
+		    harness_ptselect(ps.words[i], j) != pos) {
+			fprintf(stderr, "primitive mismatch on %#llx/%d (%s, %s)\n",
+				(unsigned long long)ps.words[i], j,
+				harness_ctz_name(), harness_ptselect_name());
+			return -1;
+		}
+	}
+	return 0;
+}
+
+/* ------------------------------------------------------------------ */
+/*  Main                                                               */
+/* ------------------------------------------------------------------ */
+
+static void usage(const char *prog)
+{
+	fprintf(stderr,
+		"Usage: %s [OPTIONS]\n"
+		"  -c, --cpus <N>                          CPUs in the simulated LLC (default: %d)\n"
+		"  -s, --smt <N>                           Threads per core (default: %d)\n"
+		"  -l, --cluster <N>                       CPUs per L2 cluster, 0 = none (default: %d)\n"
+		"  -o, --occupancy <PCT>                   Busy cores outside the target cluster (default: %d)\n"
+		"  -t, --target <CPU>                      Wakeup target (default: 0)\n"
+		"  -i, --iterations <N>                    Operations per round (default: %d)\n"
+		"  -r, --rounds <N>                        Timed rounds per row (default: %d)\n"
+		"  -p, --pin <CPU>                         Pin the benchmark to a host CPU (default: current)\n"
+		"  -a, --all-tiers                         Repeat the levels for every CTZ/PTSelect tier\n"
+		"  -h, --help                              Show this help\n",
+		prog, DEFAULT_CPUS, DEFAULT_SMT, DEFAULT_CLUSTER,
+		DEFAULT_OCCUPANCY, DEFAULT_ITERATIONS, DEFAULT_ROUNDS);
+}
+
+int main(int argc, char *argv[])
+{
+	struct harness_topo topo = {
+		.nr_cpus = DEFAULT_CPUS,
+		.smt     = DEFAULT_SMT,
+		.cluster = DEFAULT_CLUSTER,
+	};
+	struct bench_config cfg = {
+		.target     = 0,
+		.iterations = DEFAULT_ITERATIONS,
+		.rounds     = DEFAULT_ROUNDS,
+	};
+	int pin = sched_getcpu();
+	bool all_tiers = false;
+
+	static struct option long_opts[] = {
+		{"cpus",       required_argument, NULL, 'c'},
+		{"smt",        required_argument, NULL, 's'},
+		{"cluster",    required_argument, NULL, 'l'},
+		{"occupancy",  required_argument, NULL, 'o'},
+		{"target",     required_argument, NULL, 't'},
+		{"iterations", required_argument, NULL, 'i'},
+		{"rounds",     required_argument, NULL, 'r'},
+		{"pin",        required_argument, NULL, 'p'},
+		{"all-tiers",  no_argument,       NULL, 'a'},
+		{"help",       no_argument,       NULL, 'h'},
+		{NULL, 0, NULL, 0}
+	};
+
+	int opt;
+	while ((opt = getopt_long(argc, argv, "c:s:l:o:t:i:r:p:ah", long_opts,
+				  NULL)) != -1) {
+		switch (opt) {
+		case 'c': topo.nr_cpus = atoi(optarg); break;
+		case 's': topo.smt = atoi(optarg); break;
+		case 'l': topo.cluster = atoi(optarg); break;
+		case 'o': opt_occupancy = atoi(optarg); break;
+		case 't': cfg.target = atoi(optarg); break;
+		case 'i': cfg.iterations = atoi(optarg); break;
+		case 'r': cfg.rounds = atoi(optarg); break;
+		case 'p': pin = atoi(optarg); break;
+		case 'a': all_tiers = true; break;
+		case 'h': usage(argv[0]); return 0;
+		default:  usage(argv[0]); return 1;
+		}
+	}
+
+	if (harness_init(&topo) < 0) {
+		fprintf(stderr, "unsupported topology: %d CPUs, SMT%d, cluster %d "
+			"(power-of-2 SMT <= 8, power-of-2 cluster <= 64)\n",
+			topo.nr_cpus, topo.smt, topo.cluster);
+		return 1;
+	}
+	if (cfg.target < 0 || cfg.target >= topo.nr_cpus ||
+	    opt_occupancy < 0 || opt_occupancy > 100 ||
+	    cfg.iterations < 10 || cfg.rounds < 1) {
+		usage(argv[0]);
+		return 1;
+	}
+	if (check_primitives() < 0)
+		return 1;
+
+	/* One host CPU: a stable TSC and no migrations mid-round */
+	if (pin >= 0) {
+		cpu_set_t set;
+
+		CPU_ZERO(&set);
+		CPU_SET(pin, &set);
+		if (sched_setaffinity(0, sizeof(set), &set) < 0)
+			perror("sched_setaffinity");
+	}
+
+	printf("=== POC Selector Harness ===\n");
+	printf("LLC: %d CPUs (%d word%s), SMT%d, cluster %d\n",
+	       topo.nr_cpus, harness_nr_words(),
+	       harness_nr_words() > 1 ? "s" : "", topo.smt, topo.cluster);
+	printf("HW:  CTZ=%s  PTSelect=%s  (pinned to CPU %d)\n",
+	       harness_ctz_name(), harness_ptselect_name(), pin);
+
+	if (!all_tiers) {
+		run_levels(&cfg);
+	} else {
+		bool tz_rt = harness_set_tzcnt(true);
+		bool pd_rt = harness_set_pdep(true);
+
+		for (int tz = 0; tz < (tz_rt ? 2 : 1); tz++) {
+			for (int pd = 0; pd < (pd_rt ? 2 : 1); pd++) {
+				if (tz_rt)
+					harness_set_tzcnt(tz == 0);
+				if (pd_rt)
+					harness_set_pdep(pd == 0);
+				printf("\n[CTZ=%s  PTSelect=%s]",
+				       harness_ctz_name(),
+				       harness_ptselect_name());
+				run_levels(&cfg);
+			}
+		}
+		/* Back to what sched_poc_hw_init() picked */
+		harness_init(&topo);
+	}
+	run_blocks(&cfg);
+
+	printf("\nDone.\n");
+	return 0;
+}
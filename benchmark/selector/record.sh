@@ -0,0 +1,63 @@
+#!/bin/sh
+# SPDX-License-Identifier: GPL-2.0
+#
+# record.sh - Capture a wakeup trace and the CPU topology for poc_replay
+#
+# Usage: sudo ./record.sh OUT [SECONDS]
+#
+# Writes OUT.trace (sched_switch / sched_wakeup / sched_wakeup_new, the
+# tracefs text format) and OUT.topo ("cpu llc cluster core" per online
+# CPU, each ID being the first CPU of that group).  Runs on any kernel;
+# the POC selector does not need to be present on the recording host.
+#
+set -e
+
+out=$1
+secs=${2:-10}
+buf_kb=${BUF_KB:-65536}
+
+[ -n "$out" ] || { echo "usage: $0 OUT [SECONDS]" >&2; exit 1; }
+
+tr=/sys/kernel/tracing
+[ -d $tr/events ] || tr=/sys/kernel/debug/tracing
+[ -d $tr/events ] || { echo "tracefs not mounted" >&2; exit 1; }
+
+first() { cut -d, -f1 "$1" | cut -d- -f1; }
+
+# Topology
+{
+	echo '# cpu llc cluster core'
+	for d in /sys/devices/system/cpu/cpu[0-9]*; do
+		[ -e "$d/topology/thread_siblings_list" ] || continue
+		[ "$(cat "$d/online" 2>/dev/null || echo 1)" = 1 ] || continue
+		cpu=${d##*cpu}
+		core=$(first "$d/topology/thread_siblings_list")
+		cluster=$core
+		[ -e "$d/topology/cluster_cpus_list" ] &&
+			cluster=$(first "$d/topology/cluster_cpus_list")
+		llc=$(cat "$d/topology/physical_package_id")
+		for c in "$d"/cache/index*; do
+			[ "$(cat "$c/level" 2>/dev/null)" = 3 ] &&
+				llc=$(first "$c/shared_cpu_list")
+		done
+		echo "$cpu $llc $cluster $core"
+	done | sort -n
+} > "$out.topo"
+
+# Trace
+echo 0 > $tr/tracing_on
+echo > $tr/trace
+echo "$buf_kb" > $tr/buffer_size_kb
+for e in sched_switch sched_wakeup sched_wakeup_new; do
+	echo 1 > $tr/events/sched/$e/enable
+done
+echo 1 > $tr/tracing_on
+sleep "$secs"
+echo 0 > $tr/tracing_on
+for e in sched_switch sched_wakeup sched_wakeup_new; do
+	echo 0 > $tr/events/sched/$e/enable
+done
+cat $tr/trace > "$out.trace"
+echo > $tr/trace
+
+echo "$out.trace: $(grep -c sched_ "$out.trace") events, $out.topo: $(grep -vc '^#' "$out.topo") CPUs"